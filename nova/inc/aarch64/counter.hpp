@@ -30,8 +30,6 @@ class Counter final
     public:
         static Counter req[Intid::NUM_SGI]  CPULOCAL;
         static Counter loc[Intid::NUM_PPI]  CPULOCAL;
-        static Counter schedule             CPULOCAL;
-        static Counter helping              CPULOCAL;
 
         ALWAYS_INLINE
         inline void inc()
@@ -19,6 +19,7 @@
 
 #include "arch.hpp"
 #include "atomic.hpp"
+#include "config.hpp"
 #include "kmem.hpp"
 #include "spinlock.hpp"
 #include "std.hpp"
@@ -299,6 +300,9 @@ class Cpu final
         static inline cpu_t             count       { 0 };
         static inline Atomic<cpu_t>     online      { 0 };
 
+        // CPU-local data of all cores is accessible once they have passed the bootstrap barrier
+        static bool booted() { return online && online == count; }
+
         // Returns affinity in Aff3[31:24] Aff2[23:16] Aff1[15:8] Aff0[7:0] format
         static constexpr auto affinity_pack (uint64_t v) { return static_cast<uint32_t>((v >> 8 & BIT_RANGE (31, 24)) | (v & BIT_RANGE (23, 0))); }
 
@@ -315,6 +319,10 @@ class Cpu final
 
         static void preemption_point() { asm volatile ("msr daifclr, #0xf; msr daifset, #0xf" : : : "memory"); }
 
+        static uintptr_t preemption_save() { uintptr_t f; asm volatile ("mrs %0, daif; msr daifset, #0xf" : "=r" (f) : : "memory"); return f; }
+
+        static void preemption_restore (uintptr_t f) { asm volatile ("msr daif, %0" : : "r" (f) : "memory"); }
+
         static void halt() { asm volatile ("wfi; msr daifclr, #0xf; msr daifset, #0xf" : : : "memory"); }
 
         [[nodiscard]] static uint8_t feature (Cpu_feature f) { return feat_cpu64[std::to_underlying (f) / 16] >> std::to_underlying (f) % 16 * 4 & BIT_RANGE (3, 0); }
@@ -42,6 +42,9 @@ class Ec_arch final : private Ec
         void collect() override final
         {
             trace (TRACE_DESTROY, "KOBJ: EC %p collected", static_cast<void *>(this));
+
+            // CPU-local state refers to the EC, so it retires on its own CPU
+            defer (retire, cpu);
         }
 
         static void handle_irq_kern() asm ("handle_irq_kern");
@@ -20,6 +20,7 @@
 #include "list.hpp"
 #include "memory.hpp"
 #include "ptab_hpt.hpp"
+#include "refcnt.hpp"
 #include "sdid.hpp"
 #include "slab.hpp"
 #include "spinlock.hpp"
@@ -35,10 +36,10 @@ class Smmu final : public List<Smmu>
         {
             struct Entry
             {
-                Space_dma *     dma     { nullptr };
-                uint16_t        sid     { 0 };
-                uint16_t        msk     { 0 };
-                uint8_t         ctx     { 0 };
+                Refptr<Space_dma>   dma { nullptr };    // Keeps the domain alive while the SMG uses it
+                uint16_t            sid { 0 };
+                uint16_t            msk { 0 };
+                uint8_t             ctx { 0 };
             };
 
             Entry entry[256];
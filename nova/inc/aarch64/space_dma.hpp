@@ -32,6 +32,8 @@ class Space_dma final : public Space_mem<Space_dma>
         void collect() override final
         {
             trace (TRACE_DESTROY, "KOBJ: DMA %p collected", static_cast<void *>(this));
+
+            defer (reclaim<Space_dma>);
         }
 
     public:
@@ -79,9 +81,11 @@ class Space_dma final : public Space_mem<Space_dma>
             operator delete (this, cache);
         }
 
-        auto update (uint64_t v, uint64_t p, unsigned o, Paging::Permissions pm, Memattr ma) { return dptp.update (v, p, o, pm, ma); }
+        auto update (uint64_t v, uint64_t p, unsigned o, Paging::Permissions pm, Memattr ma) { Lock_guard <Spinlock> guard { lock }; return dptp.update (v, p, o, pm, ma); }
+
+        void promote (uint64_t v, unsigned o) { Lock_guard <Spinlock> guard { lock }; dptp.promote (v, o); }
 
-        void sync() { Smmu::tlb_invalidate_all (sdid); }
+        bool sync (uintptr_t, uintptr_t) { Smmu::tlb_invalidate_all (sdid); return true; }
 
         auto get_sdid() const { return sdid; }
 };
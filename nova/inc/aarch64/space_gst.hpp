@@ -31,6 +31,8 @@ class Space_gst final : public Space_mem<Space_gst>
         void collect() override final
         {
             trace (TRACE_DESTROY, "KOBJ: GST %p collected", static_cast<void *>(this));
+
+            defer (reclaim<Space_gst>);
         }
 
     public:
@@ -76,9 +78,11 @@ class Space_gst final : public Space_mem<Space_gst>
             operator delete (this, cache);
         }
 
-        auto update (uint64_t v, uint64_t p, unsigned o, Paging::Permissions pm, Memattr ma) { return nptp.update (v, p, o, pm, ma); }
+        auto update (uint64_t v, uint64_t p, unsigned o, Paging::Permissions pm, Memattr ma) { Lock_guard <Spinlock> guard { lock }; return nptp.update (v, p, o, pm, ma); }
+
+        void promote (uint64_t v, unsigned o) { Lock_guard <Spinlock> guard { lock }; nptp.promote (v, o); }
 
-        void sync() { nptp.invalidate (vmid); }
+        bool sync (uintptr_t, uintptr_t) { nptp.invalidate (vmid); return true; }
 
         void make_current() { nptp.make_current (vmid); }
 };
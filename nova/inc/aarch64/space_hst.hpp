@@ -33,6 +33,10 @@ class Space_hst final : public Space_mem<Space_hst>
         void collect() override final
         {
             trace (TRACE_DESTROY, "KOBJ: HST %p collected", static_cast<void *>(this));
+
+            get_pd()->detach (this);
+
+            defer (reclaim<Space_hst>);
         }
 
     public:
@@ -82,11 +86,15 @@ class Space_hst final : public Space_mem<Space_hst>
 
         auto lookup (uint64_t v, uint64_t &p, unsigned &o, Memattr &ma) const { return nptp.lookup (v, p, o, ma); }
 
-        auto update (uint64_t v, uint64_t p, unsigned o, Paging::Permissions pm, Memattr ma) { return nptp.update (v, p, o, pm, ma); }
+        auto update (uint64_t v, uint64_t p, unsigned o, Paging::Permissions pm, Memattr ma) { Lock_guard <Spinlock> guard { lock }; return nptp.update (v, p, o, pm, ma); }
 
-        void sync() { nptp.invalidate (vmid); }
+        void promote (uint64_t v, unsigned o) { Lock_guard <Spinlock> guard { lock }; nptp.promote (v, o); }
+
+        bool sync (uintptr_t, uintptr_t) { nptp.invalidate (vmid); return true; }
 
         void make_current() { nptp.make_current (vmid); }
 
+        void init (cpu_t) {}
+
         static void access_ctrl (uint64_t addr, size_t size, Paging::Permissions perm) { Space_mem::access_ctrl (nova, addr, size, perm, Memattr::dev()); }
 };
@@ -23,6 +23,7 @@
 
 #include "arch.hpp"
 #include "memory.hpp"
+#include "numa.hpp"
 #include "queue.hpp"
 #include "spinlock.hpp"
 
@@ -44,8 +45,9 @@ class Buddy final
                     FREE,
                 };
 
-                order_t ord { 0 };
-                Tag     tag { Tag::USED };
+                order_t ord  { 0 };
+                Tag     tag  { Tag::USED };
+                uint8_t node { 0 };
         };
 
         class Freelist final
@@ -65,18 +67,54 @@ class Buddy final
                 Queue<Block> list;
 
             public:
+                bool empty() const      { return list.empty(); }
                 void enqueue (Block *b) { list.enqueue_head (b); }
                 auto dequeue()          { return list.dequeue_head(); }
         };
 
-        static inline Spinlock      lock;       // Allocator Spinlock
+        class Zone final
+        {
+            public:
+                Spinlock    lock;       // Zone Spinlock
+                Freelist    freelist;   // Block Freelist
+                size_t      pages;      // Free Page Count
+        };
+
+        class Cache final
+        {
+            public:
+                // Orders below this limit are cached per core
+                static constexpr order_t orders { 2 };
+
+                // Number of blocks moved between cache and freelist at once
+                static constexpr unsigned batch { 16 };
+
+                // Number of blocks above which the cache is drained
+                static constexpr unsigned limit { 2 * batch };
+
+            private:
+                Queue<Block> list[orders];
+                unsigned     size[orders];
+
+            public:
+                auto count (order_t o) const { return size[o]; }
+
+                void enqueue (Block *b) { list[b->ord].enqueue_head (b); size[b->ord]++; }
+                auto dequeue (order_t o) { auto const b { list[o].dequeue_head() }; size[o] -= !!b; return b; }
+        };
+
         static inline index_t       min_idx;    // Minimum Block Index
         static inline index_t       max_idx;    // Maximum Block Index
         static inline uintptr_t     mem_base;   // Base of Memory Pool
         static inline Block *       blk_base;   // Base of Block Array
-        static inline Freelist      freelist;   // Block Freelist
+        static inline Zone          zone[Numa::nodes];  // Memory Zones (per Node)
 
         static Waitlist waitlist    CPULOCAL;   // Block Waitlist (per Core)
+        static Cache    cache       CPULOCAL;   // Block Cache (per Core, home node only)
+
+        static unsigned home();
+
+        static bool cached (order_t);
 
         static bool valid (index_t x) { return x >= min_idx && x < max_idx; }
 
@@ -86,8 +124,14 @@ class Buddy final
         static auto index_to_page (index_t x)   { return mem_base + x * PAGE_SIZE (0); }
         static auto page_to_index (uintptr_t x) { return static_cast<index_t>((x - mem_base) / PAGE_SIZE (0)); }
 
+        static Block *split (Zone &, order_t);
+        static Block *take (unsigned, order_t);
+
         NONNULL static void coalesce (Block *);
 
+        static void refill (order_t);
+        static void drain (order_t);
+
     public:
         enum class Fill
         {
@@ -97,11 +141,17 @@ class Buddy final
         };
 
         static void init();
+        static void partition();
+
+        static size_t available (unsigned n) { return zone[n].pages * PAGE_SIZE (0); }
 
         [[nodiscard]] static void *alloc (order_t, Fill = Fill::NONE);
 
         static void free (void *);
         static void wait (void *);
 
-        static void free_wait() { for (Block *b; (b = waitlist.dequeue()); coalesce (b)); }
+        static void free_wait();
+        static void leak_wait();
+
+        static bool waiting() { return !waitlist.empty(); }
 };
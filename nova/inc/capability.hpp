@@ -177,8 +177,8 @@ class Capability final
             // Must not be a null capability
             assert (o);
 
-            // Release reference
-            o->ref_dec();
+            // Release reference, the creator still owns the object
+            o->ref_undo();
         }
 
         /*
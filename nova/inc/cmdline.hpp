@@ -30,6 +30,7 @@ class Cmdline final
     public:
         // Command line parameters must be in a measured section
         SEC_HASH static inline bool insecure { false };
+        SEC_HASH static inline bool lazydma  { false };
         SEC_HASH static inline bool noccst   { false };
         SEC_HASH static inline bool nocpst   { false };
         SEC_HASH static inline bool nodl     { false };
@@ -38,6 +39,7 @@ class Cmdline final
         SEC_HASH static inline bool nosmmu   { false };
         SEC_HASH static inline bool nouart   { false };
         SEC_HASH static inline bool novpid   { false };
+        SEC_HASH static inline bool steal    { false };
 
         static void init();
 
@@ -49,6 +51,7 @@ class Cmdline final
         } options[]
         {
             { "insecure",   insecure    },
+            { "lazydma",    lazydma     },
             { "noccst",     noccst      },
             { "nocpst",     nocpst      },
             { "nodl",       nodl        },
@@ -57,6 +60,7 @@ class Cmdline final
             { "nosmmu",     nosmmu      },
             { "nouart",     nouart      },
             { "novpid",     novpid      },
+            { "steal",      steal       },
         };
 
         static inline size_t arg_len (char const *&);
@@ -58,6 +58,7 @@
         #define INIT_PRIORITY(X)        __attribute__((init_priority((X))))
         #define NOINLINE                __attribute__((noinline))
         #define NONNULL                 __attribute__((nonnull))
+        #define TARGET(X)               __attribute__((target (X)))
 
         #define SEC_DATA                __attribute__((section (".data"), used))
         #define SEC_HASH                __attribute__((section (".text"), used))
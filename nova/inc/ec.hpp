@@ -46,14 +46,18 @@ class Ec : public Kobject, private Queue<Sc>, public Queue<Ec>::Element
 
         Cpu_regs            regs;
         unsigned long const evt;
-        cpu_t         const cpu;
+        Atomic<cpu_t>       cpu;                    // Written by Ec::migrate on the old CPU, read by other CPUs
+        cpu_t               home        { 0 };      // CPU where a cross-CPU portal call originated
+        uint64_t            hop         { 0 };      // Start of a pending cross-CPU migration (STC ticks)
         Fpu *         const fpu;
         void *        const kpage;
+        uintptr_t           kmap        { 0 };
         Ec *                callee      { nullptr };
         Ec *                caller      { nullptr };
         Atomic<cont_t>      cont        { nullptr };
         Timeout_hypercall   timeout     { this };
         Spinlock            lock;
+        unsigned            scs         { 0 };
 
         static Atomic<Ec *> current asm ("current") CPULOCAL;
         static Ec *         fpowner                 CPULOCAL;
@@ -91,9 +95,13 @@ class Ec : public Kobject, private Queue<Sc>, public Queue<Ec>::Element
         NOINLINE
         void handle_hazard (unsigned, cont_t);
 
+        void return_home (cont_t);
+
         NOINLINE
         void help (Ec *, cont_t);
 
+        static void retire (Rcu_elem *);
+
         ALWAYS_INLINE
         inline void rendezvous (Ec *, cont_t, cont_t, uintptr_t, uintptr_t, uintptr_t);
 
@@ -187,12 +195,7 @@ class Ec : public Kobject, private Queue<Sc>, public Queue<Ec>::Element
         // Factory: GST EC
         [[nodiscard]] static Ec *create_gst (Status &s, Pd *, bool, bool, cpu_t, unsigned long, uintptr_t, uintptr_t);
 
-        void destroy()
-        {
-            this->~Ec();
-
-            operator delete (this, cache);
-        }
+        void destroy();
 
         static void create_idle();
         static void create_root();
@@ -264,6 +267,44 @@ class Ec : public Kobject, private Queue<Sc>, public Queue<Ec>::Element
             for (Sc *sc; (sc = dequeue_head()); Scheduler::unblock (sc)) ;
         }
 
+        /*
+         * Bind an SC to the EC
+         *
+         * @return      CPU of the EC, which becomes the CPU of the SC
+         */
+        ALWAYS_INLINE
+        inline cpu_t bind_sc()
+        {
+            Lock_guard <Spinlock> guard { lock };
+
+            scs++;
+
+            return cpu;
+        }
+
+        ALWAYS_INLINE
+        inline void unbind_sc()
+        {
+            Lock_guard <Spinlock> guard { lock };
+
+            scs--;
+        }
+
+        /*
+         * Determine if the EC can ever follow its SC to another CPU
+         *
+         * @return      True if the EC is global and only one SC is bound to it, false otherwise
+         */
+        ALWAYS_INLINE
+        inline bool migratable()
+        {
+            Lock_guard <Spinlock> guard { lock };
+
+            return subtype == Kobject::Subtype::EC_GLOBAL && scs == 1;
+        }
+
+        bool migrate (cpu_t);
+
         ALWAYS_INLINE
         inline void set_timeout (uint64_t t, Sm *s)
         {
@@ -276,6 +317,15 @@ class Ec : public Kobject, private Queue<Sc>, public Queue<Ec>::Element
             timeout.dequeue();
         }
 
+        /*
+         * Turn a pending timeout into a no-op because its SM goes away
+         */
+        ALWAYS_INLINE
+        inline void detach_timeout()
+        {
+            timeout.detach();
+        }
+
         void activate();
 
         void adjust_offset_ticks (uint64_t);
@@ -27,9 +27,9 @@
  */
 class Sha
 {
-    private:
-        size_t len { 0 };
+    friend class Sha_arch;
 
+    private:
         // The first 64 bits of the fractional parts of the cube roots of the first 80 prime numbers
         static constexpr uint64_t cbr[80]
         {
@@ -68,8 +68,10 @@ class Sha
         static constexpr uint64_t sig1 (uint64_t x) { return ror (x, 19) ^ ror (x, 61) ^ shr (x,  6); }
 
     protected:
+        size_t len { 0 };
+
         // Section 5
-        template<typename T> void preprocess (T *h, uint8_t const *m, size_t s, bool more, void (*hash)(T *, uint8_t const *))
+        template<typename T, typename F> void preprocess (uint8_t const *m, size_t s, bool more, F const &hash)
         {
             constexpr auto res_size { 14 * sizeof (T) }, blk_size { 16 * sizeof (T) };
 
@@ -77,8 +79,11 @@ class Sha
             len += s;
 
             // Process full blocks
-            for (; s >= blk_size; s -= blk_size, m += blk_size)
-                hash (h, m);
+            if (s >= blk_size) {
+                hash (m, s / blk_size);
+                m += s & ~(blk_size - 1);
+                s &= blk_size - 1;
+            }
 
             // If more blocks follow, then s must have been a multiple of blk_size and is now 0
             if (more)
@@ -96,7 +101,7 @@ class Sha
                 while (s < blk_size)
                     b[s++] = 0;
 
-                hash (h, b);
+                hash (b, 1);
 
                 s = 0;
             }
@@ -109,9 +114,35 @@ class Sha
             // Append the length info in bits to the last block
             *reinterpret_cast<Unaligned_be<L> *>(b + res_size) = 8 * len;
 
-            hash (h, b);
+            hash (b, 1);
         }
 
+        // Section 6.1
+        template<typename T> static void sha1 (T *h, uint8_t const *m, size_t n)
+        {
+            for (; n--; m += 16 * sizeof (T))
+                sha1 (h, m);
+        }
+
+        // Section 6.2, 6.3, 6.4, 6.5
+        template<typename T> static void sha2 (T *h, uint8_t const *m, size_t n)
+        {
+            for (; n--; m += 16 * sizeof (T))
+                sha2 (h, m);
+        }
+
+    public:
+        // Block functions process n consecutive blocks, dual block functions do so for two hash values
+        template<typename T> using Block = void (*)(T *, uint8_t const *, size_t);
+        template<typename T> using Dual  = void (*)(T *, T *, uint8_t const *, size_t);
+
+        // Block functions for SHA-1 (0) and SHA-2 (1), which Sha_arch::init may replace with accelerated ones
+        template<typename T> static inline Block<T> block[] { sha1<T>, sha2<T> };
+
+        // Dual block function for SHA-2, which Sha_arch::init may provide
+        template<typename T> static inline Dual<T> dual { nullptr };
+
+    private:
         // Section 6.1
         template<typename T> static void sha1 (T *h, uint8_t const *m)
         {
@@ -192,11 +223,11 @@ class Sha
 
 template<unsigned F, unsigned D, unsigned H, typename T, T... I> class Hash : private Sha
 {
+    template<unsigned, unsigned, unsigned, typename U, U...> friend class Hash;
+
     private:
         T h[H] { I... };
 
-        static constexpr void (*hash[])(T *, uint8_t const *) { sha1, sha2 };
-
     public:
         static constexpr auto digest { D };
 
@@ -206,7 +237,29 @@ template<unsigned F, unsigned D, unsigned H, typename T, T... I> class Hash : pr
                 reinterpret_cast<Unaligned_be<T> *>(p)[i] = h[i];
         }
 
-        void update (uint8_t const *m, size_t s, bool more = false) { preprocess (h, m, s, more, hash[F]); }
+        void update (uint8_t const *m, size_t s, bool more = false)
+        {
+            preprocess<T> (m, s, more, [this] (uint8_t const *b, size_t n) { block<T>[F] (h, b, n); });
+        }
+
+        /*
+         * Update this hash and another SHA-2 hash of the same word size with the same message
+         *
+         * With a dual block function, both hash values are computed in a single pass over the
+         * message, which requires that both hashes have processed the same amount of data so far.
+         */
+        template<unsigned E, unsigned K, T... J> void update (Hash<F, E, K, T, J...> &o, uint8_t const *m, size_t s, bool more = false)
+        {
+            if (EXPECT_FALSE (!F || !dual<T> || len != o.len)) {
+                update (m, s, more);
+                o.update (m, s, more);
+                return;
+            }
+
+            o.len += s;
+
+            preprocess<T> (m, s, more, [this, &o] (uint8_t const *b, size_t n) { dual<T> (h, o.h, b, n); });
+        }
 };
 
 class Hash_sha1_160 final : public Hash<0, 20, 5, uint32_t, 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0> {};
@@ -39,6 +39,7 @@ class Hazard final
             RCU         = BIT  (2),
             TR          = BIT (15),     // x86 only
             FPU         = BIT (16),
+            HOME        = BIT (28),
             TSC         = BIT (29),     // x86 only
             RECALL      = BIT (30),
             ILLEGAL     = BIT (31),
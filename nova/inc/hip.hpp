@@ -23,7 +23,9 @@
 #pragma once
 
 #include "atomic.hpp"
+#include "config.hpp"
 #include "hip_arch.hpp"
+#include "numa.hpp"
 #include "std.hpp"
 
 class Hip final
@@ -31,6 +33,8 @@ class Hip final
     private:
         using feat_t = uint64_t;
 
+        static constexpr unsigned cpus { NUM_CPU };                                 // CPUs with reported node affinity and statistics
+
         uint32_t        signature;                                                  // 0x0
         uint16_t        checksum, length;                                           // 0x4
         uint64_t        nova_p_addr, nova_e_addr;                                   // 0x8
@@ -46,6 +50,11 @@ class Hip final
         uint16_t        kimax;                                                      // 0x76
         Atomic<feat_t>  features;                                                   // 0x78
         Hip_arch        arch;                                                       // 0x80
+        uint8_t         arch_pad[0x20 - sizeof (Hip_arch)];                         // The architecture-specific part spans 0x80-0x9f
+        uint16_t        numa_num, reserved[3];                                      // 0xa0
+        uint64_t        numa_mem[Numa::nodes];                                      // 0xa8
+        uint8_t         numa_cpu[cpus];                                             // 0xe8
+        uint64_t        stat_p_addr[cpus];                                          // 0xe8 + cpus
 
     public:
         static Hip *hip;
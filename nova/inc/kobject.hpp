@@ -22,10 +22,11 @@
 #pragma once
 
 #include "macros.hpp"
+#include "rcu.hpp"
 #include "refcnt.hpp"
 #include "slab.hpp"
 
-class Kobject : public Refcnt
+class Kobject : public Refcnt, public Rcu_elem
 {
     friend class Capability;
 
@@ -63,7 +64,29 @@ class Kobject : public Refcnt
         Type    const   type;
         Subtype const   subtype;
 
-        explicit Kobject (Type t, Subtype s = Subtype::NONE) : type { t }, subtype { s } {}
+        explicit Kobject (Type t, Subtype s = Subtype::NONE) : Rcu_elem { nullptr }, type { t }, subtype { s } {}
+
+        /*
+         * Invoke a function on the object after all CPUs passed through a quiescent state
+         *
+         * @param f     Function that is invoked with the object
+         */
+        void defer (void (*f)(Rcu_elem *)) { func = f; Rcu::submit (this); }
+
+        /*
+         * Invoke a function on the object on the specified CPU after all CPUs passed through a quiescent state
+         *
+         * @param f     Function that is invoked with the object
+         * @param c     CPU that invokes the function
+         */
+        void defer (void (*f)(Rcu_elem *), cpu_t c) { func = f; Rcu::submit (c, this); }
+
+        /*
+         * Destroy an object whose last reference is gone
+         *
+         * @param e     Object that is being destroyed
+         */
+        template<typename T> static void reclaim (Rcu_elem *e) { static_cast<T *>(e)->destroy(); }
 
         [[nodiscard]] static void *operator new (size_t, Slab_cache &cache) noexcept
         {
@@ -0,0 +1,63 @@
+/*
+ * Non-Uniform Memory Access (NUMA) Topology
+ *
+ * Copyright (C) 2019-2024 Udo Steinberg, BedRock Systems, Inc.
+ *
+ * This file is part of the NOVA microhypervisor.
+ *
+ * NOVA is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * NOVA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ */
+
+#pragma once
+
+#include "compiler.hpp"
+#include "types.hpp"
+
+class Numa final
+{
+    public:
+        static constexpr unsigned nodes { 8 };                  // Maximum number of nodes
+
+    private:
+        struct Memory
+        {
+            uint64_t    base;
+            uint64_t    size;
+            uint8_t     node;
+        };
+
+        struct Processor
+        {
+            uint32_t    id;
+            uint8_t     node;
+        };
+
+        static inline uint32_t  domain[nodes];                  // Proximity Domain of each Node
+        static inline Memory    memory[64];                     // Memory Affinity
+        static inline Processor processor[256];                 // Processor Affinity
+
+        static inline unsigned  num_dom { 0 };
+        static inline unsigned  num_mem { 0 };
+        static inline unsigned  num_prc { 0 };
+
+        static unsigned node_by_domain (uint32_t);
+
+    public:
+        static inline unsigned  count   { 1 };                  // Number of Nodes (at least 1)
+
+        static uint8_t          node    CPULOCAL;               // Node of this CPU
+
+        static void add_memory (uint64_t, uint64_t, uint32_t);
+        static void add_processor (uint32_t, uint32_t);
+
+        static unsigned node_by_phys (uint64_t);
+
+        static void init (uint32_t);
+};
@@ -51,11 +51,21 @@ class Pd final : public Kobject
         void collect() override final
         {
             trace (TRACE_DESTROY, "KOBJ: PD %p collected", static_cast<void *>(this));
+
+            defer (reclaim<Pd>);
         }
 
         auto attach (Kobject::Subtype s) { return !spaces.test_and_set (BIT (std::to_underlying (s))); }
         void detach (Kobject::Subtype s) { spaces &= ~BIT (std::to_underlying (s)); }
 
+        template<typename T> void detach (Atomic<T *> &a, T *o, Kobject::Subtype s)
+        {
+            T *n { nullptr };
+
+            if (a.compare_exchange (o, n))
+                detach (s);
+        }
+
         static Slab_cache cache;
 
     public:
@@ -90,6 +100,11 @@ class Pd final : public Kobject
         Space_hst *get_hst() const { return space_hst; }
         Space_pio *get_pio() const { return space_pio; }
 
+        // Forget an attached space whose last reference is gone
+        void detach (Space_obj *o) { detach (space_obj, o, Kobject::Subtype::OBJ); }
+        void detach (Space_hst *o) { detach (space_hst, o, Kobject::Subtype::HST); }
+        void detach (Space_pio *o) { detach (space_pio, o, Kobject::Subtype::PIO); }
+
         Space_dma *create_dma (Status &, Space_obj *, unsigned long);
         Space_gst *create_gst (Status &, Space_obj *, unsigned long);
         Space_hst *create_hst (Status &, Space_obj *, unsigned long);
@@ -99,7 +114,7 @@ class Pd final : public Kobject
 
         static Pd *create_pd (Status &, Space_obj *, unsigned long, unsigned);
         static Ec *create_ec (Status &, Space_obj *, unsigned long, Pd *, cpu_t, uintptr_t, uintptr_t, uintptr_t, uint8_t);
-        static Sc *create_sc (Status &, Space_obj *, unsigned long, Ec *, cpu_t, uint16_t, uint8_t, uint16_t);
+        static Sc *create_sc (Status &, Space_obj *, unsigned long, Ec *, uint16_t, uint8_t, uint16_t);
         static Pt *create_pt (Status &, Space_obj *, unsigned long, Ec *, uintptr_t);
         static Sm *create_sm (Status &, Space_obj *, unsigned long, uint64_t, unsigned = ~0U);
 };
@@ -39,6 +39,8 @@ class Pt final : public Kobject
         void collect() override final
         {
             trace (TRACE_DESTROY, "KOBJ: PT %p collected", static_cast<void *>(this));
+
+            defer (reclaim<Pt>);
         }
 
     public:
@@ -79,6 +79,11 @@ template<typename T, typename I, typename O> class Ptab
 
         Status update (IAddr, OAddr, unsigned, Paging::Permissions, Memattr);
 
+        void promote (IAddr, unsigned);
+
+        void destroy (bool = false);
+        void destroy (Ptab const &);
+
         [[nodiscard]] inline auto root_init (unsigned l = T::lev() - 1) { return walk (0, l, true); }
 
         ALWAYS_INLINE
@@ -114,7 +119,8 @@ template<typename T, typename I, typename O> class Ptab
             T::noncoherent ? Cache::data_clean (this, n * sizeof (entry)) : T::publish();
         }
 
-        void deallocate (unsigned);
+        void deallocate (unsigned, bool = false);
+        void deallocate_root (unsigned, Ptab const *);
 
         [[nodiscard]] static inline void *operator new (size_t, unsigned o) noexcept
         {
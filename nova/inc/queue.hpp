@@ -56,16 +56,34 @@ template<typename T> class Queue
         ALWAYS_INLINE
         inline bool empty() const { return !head; }
 
+        /*
+         * Determine the head element of this queue
+         *
+         * @return      Head element or nullptr
+         */
+        ALWAYS_INLINE
+        inline auto first() const { return static_cast<T *>(head); }
+
+        /*
+         * Determine the tail element of this queue
+         *
+         * @return      Tail element or nullptr
+         */
+        ALWAYS_INLINE
+        inline auto last() const { return head ? static_cast<T *>(head->prev) : nullptr; }
+
         /*
          * Enqueue element into this queue
          *
-         * @param e     Element to enqueue
+         * @param t     Element to enqueue
          * @param h     Enqueue as head (true) or tail (false)
          * @return      True if the queue was empty, false otherwise
          */
         ALWAYS_INLINE NONNULL
-        inline bool enqueue (T *e, bool h)
+        inline bool enqueue (T *t, bool h)
         {
+            Element *const e { t };
+
             assert (!e->queued());
 
             if (!head) {
@@ -92,11 +110,13 @@ template<typename T> class Queue
         /*
          * Dequeue element from this queue
          *
-         * @param e     Element to dequeue
+         * @param t     Element to dequeue
          */
         ALWAYS_INLINE NONNULL
-        inline void dequeue (T *e)
+        inline void dequeue (T *t)
         {
+            Element *const e { t };
+
             assert (e->queued());
 
             if (e == e->next)
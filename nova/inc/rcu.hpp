@@ -77,6 +77,8 @@ class Rcu
         // Number of CPUs that still need to pass through a quiescent state in epoch E
         static inline Atomic<cpu_t, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST> count { 0 };
 
+        static Atomic<Rcu_elem *> remote CPULOCAL;  // Callbacks submitted by other CPUs
+
         static List     next    CPULOCAL;  // Callbacks handled in a future epoch
         static List     curr    CPULOCAL;  // Callbacks handled in epoch_c
         static List     done    CPULOCAL;  // Callbacks completed in earlier epochs
@@ -95,4 +97,5 @@ class Rcu
         static void check();
 
         static void submit (Rcu_elem *e) { next.enqueue (e); }
+        static void submit (cpu_t, Rcu_elem *);
 };
@@ -58,6 +58,14 @@ class Refcnt
             ++ref;
         }
 
+        // Decrement refcount of an unpublished object without collecting it
+        void ref_undo()
+        {
+            assert (ref == 1);
+
+            --ref;
+        }
+
         // Decrement refcount unconditionally
         void ref_dec()
         {
@@ -23,32 +23,65 @@
 #pragma once
 
 #include "ec.hpp"
+#include "statistics.hpp"
+#include "timeout_replenish.hpp"
 
 class Sc final : public Kobject, public Queue<Sc>::Element
 {
     friend class Scheduler;
 
+    public:
+        /*
+         * Scheduling statistics, only written by the CPU of the SC. The layout is ABI.
+         */
+        struct Stats
+        {
+            Statistics::Count   used;                   // 0x0: Execution time in STC ticks
+            Statistics::Count   dispatch;               // 0x8: Dispatches
+            Statistics::Count   preempt;                // 0x10: Preemptions with budget left
+            Statistics::Count   deplete;                // 0x18: Budget exhaustions
+            Statistics::Count   helping;                // 0x20: Helping episodes
+            Statistics::Count   wakeup[8];              // 0x28: Wakeup-to-dispatch latency histogram: bucket n counts [4^n, 4^(n+1)) µs, the last one beyond
+        };
+
     private:
         Refptr<Ec> const    ec;
         uint64_t   const    budget;
-        cpu_t      const    cpu;
+        cpu_t               cpu;
+        Atomic<cpu_t>       dst;
         cos_t      const    cos;
         uint8_t    const    prio;
-        Atomic<uint64_t>    used    { 0 };
         uint64_t            left    { 0 };
         uint64_t            last    { 0 };
+        Atomic<bool>        dead    { false };
+        Sc *                rel     { nullptr };    // Release queue link
+        Atomic<uint32_t>    latency { 0 };
+        uint32_t            waitlat { 0 };          // Latency bound the SC contributes while blocked (0 for none)
+        uint64_t            woken   { 0 };          // Time of the last unblock (0 once dispatched)
+        Atomic<uint64_t>    period  { 0 };          // Replenishment period (0 for none)
+        Atomic<bool>        sporadic { false };     // Replenish relative to activation, not period boundaries
+        uint64_t            per     { 0 };          // Replenishment period in effect
+        uint64_t            cap     { 0 };          // Remaining capacity in the current period
+        uint64_t            next    { 0 };          // Next replenishment time
+        bool                armed   { false };
+        bool                parked  { false };
+        Timeout_replenish   refill  { this };
+        Stats               stats;
 
         static Slab_cache   cache;
 
-        Sc (Refptr<Ec>&, cpu_t, uint16_t, uint8_t, cos_t);
+        Sc (Refptr<Ec>&, uint16_t, uint8_t, cos_t);
 
         void collect() override final
         {
             trace (TRACE_DESTROY, "KOBJ: SC %p collected", static_cast<void *>(this));
+
+            // The SC may still be queued, so its CPU reclaims it when dispatching it next
+            dead = true;
         }
 
     public:
-        [[nodiscard]] static Sc *create (Status &s, Ec *ec, cpu_t cpu, uint16_t budget, uint8_t prio, cos_t cos)
+        [[nodiscard]] static Sc *create (Status &s, Ec *ec, uint16_t budget, uint8_t prio, cos_t cos)
         {
             // Acquire reference
             Refptr<Ec> ref_ec { ec };
@@ -59,7 +92,7 @@ class Sc final : public Kobject, public Queue<Sc>::Element
 
             else {
 
-                auto const sc { new (cache) Sc { ref_ec, cpu, budget, prio, cos } };
+                auto const sc { new (cache) Sc { ref_ec, budget, prio, cos } };
 
                 // If we created sc, then reference must have been consumed
                 assert (!sc || !ref_ec);
@@ -73,14 +106,53 @@ class Sc final : public Kobject, public Queue<Sc>::Element
             return nullptr;
         }
 
-        void destroy()
+        void destroy();
+
+        Ec *get_ec() const { return ec; }
+
+        uint64_t get_used() const { return stats.used.get(); }
+
+        auto &get_stats() { return stats; }
+
+        /*
+         * Request migration to another CPU
+         *
+         * The SC moves when its current CPU dispatches it next.
+         */
+        void migrate (cpu_t c) { dst = c; }
+
+        /*
+         * Bound the wakeup latency (in µs, 0 for none) of idle states its CPU enters while the SC waits
+         */
+        void set_latency (uint32_t l) { latency = l; }
+
+        /*
+         * Determine if a period can hold the budget of the SC
+         *
+         * @param p     Period (in ticks, 0 for none)
+         * @return      True if the period is 0 or not shorter than the budget, false otherwise
+         */
+        bool valid_period (uint64_t p) const { return !p || p >= budget; }
+
+        /*
+         * Limit the SC to its budget per period (0 for none)
+         *
+         * The change takes effect when its CPU dispatches the SC next.
+         *
+         * @param p     Valid period (in ticks)
+         * @param s     Sporadic (true) or periodic (false) replenishment
+         */
+        void set_period (uint64_t p, bool s)
         {
-            this->~Sc();
+            assert (valid_period (p));
 
-            operator delete (this, cache);
+            sporadic = s;
+            period = p;
         }
 
-        Ec *get_ec() const { return ec; }
+        uint64_t server (uint64_t);
 
-        uint64_t get_used() const { return used; }
+        void replenish();
 };
+
+static_assert (__is_standard_layout (Sc::Stats) && __builtin_offsetof (Sc::Stats, wakeup) == 0x28);
@@ -22,8 +22,10 @@
 
 #pragma once
 
+#include "atomic.hpp"
+#include "bits.hpp"
+#include "kmem.hpp"
 #include "queue.hpp"
-#include "spinlock.hpp"
 
 class Sc;
 
@@ -31,12 +33,25 @@ class Scheduler final
 {
     public:
         static constexpr auto priorities { 128 };
+        static constexpr auto residual_ms { 100U };     // Tick of a CPU whose lone SC runs without a budget timeout
+
+        // Load statistics
+        struct Load final
+        {
+            Atomic<unsigned>    ready   { 0 };  // Ready SCs (excluding idle)
+            Atomic<bool>        idle    { false };
+        };
 
         static void unblock (Sc *);
         static void requeue();
 
+        static auto get_load (cpu_t c) { return Kmem::loc_to_glob (c, &load); }
+
         static auto get_current() { return current; }
 
+        // Smallest wakeup latency bound of the SCs blocked on this CPU, rounded down to a power of 2 (0 for none)
+        static uint32_t get_latency() { return waitmap ? BIT (bit_scan_forward (waitmap)) : 0; }
+
         static void set_current (Sc *s) { current = s; }
 
         [[noreturn]] static void schedule (bool = false);
@@ -47,26 +62,64 @@ class Scheduler final
         {
             private:
                 Queue<Sc>   queue[priorities];
-                unsigned    prio_top { 0 };
+                uint64_t    prio_map[priorities / 64] { 0 };    // Priorities with non-empty queues
+                unsigned    prio_sum { 0 };                     // Words of prio_map with bits set
+
+                void set (unsigned p)
+                {
+                    prio_map[p / 64] |= BIT64 (p % 64);
+                    prio_sum |= BIT (p / 64);
+                }
+
+                void clr (unsigned p)
+                {
+                    if (!(prio_map[p / 64] &= ~BIT64 (p % 64)))
+                        prio_sum &= ~BIT (p / 64);
+                }
+
+                // Highest priority with a non-empty queue (0 if all are empty)
+                unsigned prio_top() const
+                {
+                    if (EXPECT_FALSE (!prio_sum))
+                        return 0;
+
+                    auto const w { static_cast<unsigned>(bit_scan_reverse (prio_sum)) };
+
+                    return w * 64 + static_cast<unsigned>(bit_scan_reverse (prio_map[w]));
+                }
 
             public:
                 void enqueue (Sc *, uint64_t);
                 auto dequeue (uint64_t);
+
+                bool empty (unsigned p) const { return !(prio_map[p / 64] & BIT64 (p % 64)); }
+
+                bool offload (cpu_t);
         };
 
-        // Release queue
+        // Release queue (lock-free, multiple producers, single consumer)
         class Release final
         {
             private:
-                Queue<Sc>   queue;
-                Spinlock    lock;
+                Atomic<Sc *>    head    { nullptr };    // Released SCs in LIFO order
+                Atomic<bool>    kick    { false };      // RRQ IPI pending
 
             public:
                 void enqueue (Sc *);
-                auto dequeue();
+                Sc * dequeue();
         };
 
         static Ready        ready       CPULOCAL;
         static Release      release     CPULOCAL;
+        static Load         load        CPULOCAL;
         static Sc *         current     CPULOCAL;
+        static uint16_t     waiting[32] CPULOCAL;   // Blocked SCs with a wakeup latency bound, by bit_scan_reverse (bound)
+        static uint32_t     waitmap     CPULOCAL;   // Non-empty buckets of waiting
+        static bool         tickless    CPULOCAL;   // Current SC runs without a budget timeout
+
+        static inline Atomic<unsigned> idlers { 0 };
+
+        static bool migrate (Sc *, cpu_t);
+        static void balance();
+        static uint64_t settle (uint64_t);
 };
@@ -28,17 +28,57 @@ class Slab_cache final
 {
     private:
         struct Slab;
+        struct Magazine;
+
+        // Magazine pair (per Core)
+        struct Local
+        {
+            Magazine *  loaded;                 // Loaded Magazine
+            Magazine *  previous;               // Previous Magazine
+        };
+
+        // Magazine depot (shared)
+        struct Depot
+        {
+            Magazine *  full    { nullptr };    // Full Magazine List
+            Magazine *  empty   { nullptr };    // Empty Magazine List
+            unsigned    count   { 0 };          // Full Magazine Count
+            Spinlock    lock;                   // Depot Spinlock
+
+            static constexpr unsigned limit { 8 };
+
+            Magazine *get_full();
+            Magazine *get_empty();
+
+            bool put_full (Magazine *);
+            void put_empty (Magazine *);
+        };
+
+        // Number of slab caches with a magazine layer
+        static constexpr unsigned slots { 8 };
+
+        static Local            local[slots] CPULOCAL;
+        static Depot            depot[slots];
+        static inline unsigned  slots_used { 0 };
 
         uint16_t const  bsz;                    // Buffer size
         uint16_t const  bps;                    // Buffers per Slab
+        uint8_t  const  slot;                   // Magazine Slot (0 = none)
         Slab *          curr    { nullptr };    // Current (Partial) Slab
         Slab *          head    { nullptr };    // Head of Slab List
         Spinlock        lock;                   // Allocator Spinlock
 
+        bool magazines() const;
+
+        [[nodiscard]] void *get();
+        void put (void *);
+
+        void flush (Magazine *);
+
     public:
         [[nodiscard]] void *alloc();
 
         void free (void *);
 
-        Slab_cache (size_t, size_t);
+        Slab_cache (size_t, size_t, bool = false);
 };
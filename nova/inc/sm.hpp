@@ -38,6 +38,43 @@ class Sm final : public Kobject, private Queue<Ec>
         void collect() override final
         {
             trace (TRACE_DESTROY, "KOBJ: SM %p collected", static_cast<void *>(this));
+
+            // Abort waiters once no down operation can be in flight
+            defer (retire);
+        }
+
+        /*
+         * Abort all waiters and reclaim the SM after their timeouts stopped referring to it
+         *
+         * @param e     SM that is being retired
+         */
+        static void retire (Rcu_elem *e)
+        {
+            auto const sm { static_cast<Sm *>(e) };
+
+            sm->abort();
+            sm->defer (reclaim<Sm>);
+        }
+
+        /*
+         * Release all ECs that are blocked on the SM with an ABORTED status
+         */
+        void abort()
+        {
+            for (Ec *ec;; ec->unblock_sc()) {
+
+                {   Lock_guard <Spinlock> guard { lock };
+
+                    if (!(ec = dequeue_head()))
+                        return;
+
+                    // A pending timeout must no longer refer to the SM
+                    ec->detach_timeout();
+
+                    // The EC can now be activated again
+                    ec->unblock (Ec::sys_finish<Status::ABORTED, true>, false);
+                }
+            }
         }
 
     public:
@@ -22,14 +22,18 @@
 #pragma once
 
 #include "bits.hpp"
+#include "lock_guard.hpp"
 #include "memattr.hpp"
 #include "memory.hpp"
 #include "paging.hpp"
 #include "space.hpp"
+#include "spinlock.hpp"
 
 template<typename T> class Space_mem : public Space
 {
     protected:
+        Spinlock lock;      // Serializes page-table updates with promotions
+
         Space_mem (Kobject::Subtype s) : Space { s } {}
 
         Space_mem (Kobject::Subtype s, Refptr<Pd> &p) : Space { s, p } {}
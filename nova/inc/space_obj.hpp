@@ -48,9 +48,16 @@ class Space_obj final : public Space
         void collect() override final
         {
             trace (TRACE_DESTROY, "KOBJ: OBJ %p collected", static_cast<void *>(this));
+
+            get_pd()->detach (this);
+
+            defer (reclaim<Space_obj>);
         }
 
         Atomic<Capability> *walk (unsigned long, bool);
+        Atomic<Capability> const *walk (unsigned long) const;
+
+        static void install (Atomic<Capability> *, Capability);
 
     public:
         static Space_obj nova;
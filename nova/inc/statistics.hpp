@@ -0,0 +1,80 @@
+/*
+ * Hypervisor Statistics
+ *
+ * Copyright (C) 2019-2024 Udo Steinberg, BedRock Systems, Inc.
+ *
+ * This file is part of the NOVA microhypervisor.
+ *
+ * NOVA is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * NOVA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ */
+
+#pragma once
+
+#include "atomic.hpp"
+#include "cpu.hpp"
+#include "event.hpp"
+#include "kmem.hpp"
+
+/*
+ * Each CPU has a statistics page, which is mapped at MMAP_CPU_STAT, only
+ * written by that CPU and readable by the root task. The layout is ABI.
+ */
+class Statistics final
+{
+    private:
+        static Statistics *alias CPULOCAL;                  // Global alias of the statistics page
+
+    public:
+        class Count final
+        {
+            private:
+                Atomic<uint64_t> val;
+
+            public:
+                ALWAYS_INLINE
+                inline void inc() { val = val + 1; }
+
+                ALWAYS_INLINE
+                inline void add (uint64_t v) { val = val + v; }
+
+                ALWAYS_INLINE
+                inline uint64_t get() const { return val; }
+        };
+
+        Count   syscall[16];                                // 0x0: Hypercalls by number
+        Count   ipc_call;                                   // 0x80: IPC rendezvous (portal calls and event messages)
+        Count   ipc_reply;                                  // 0x88: IPC replies
+        Count   page_fault;                                 // 0x90: Page faults of host ECs and the kernel
+        Count   tlb_send;                                   // 0x98: TLB shootdowns sent to other CPUs
+        Count   tlb_recv;                                   // 0xa0: TLB shootdowns received from other CPUs
+        Count   rcu_epoch;                                  // 0xa8: RCU grace periods observed
+        Count   buddy_alloc, buddy_free;                    // 0xb0: Buddy allocator operations
+        Count   slab_alloc,  slab_free;                     // 0xc0: Slab allocator operations
+        Count   schedule;                                   // 0xd0: Scheduler invocations
+        Count   helping;                                    // 0xd8: Helping operations
+        Count   idle;                                       // 0xe0: Idle time in STC ticks
+        Count   ipc_xcpu;                                   // 0xe8: Portal calls carried to another CPU
+        Count   sched_scan;                                 // 0xf0: Empty priority levels skipped by the ready-queue bitmap
+        Count   ipc_xcpu_hop;                               // 0xf8: STC ticks portal calls spent migrating between CPUs
+        Count   vmexit[Event::gst_arch];                    // 0x100: VM exits by architectural reason
+        Count   cstate[8];                                  // 0x900 (x86_64), 0x300 (aarch64): C-states chosen by the idle governor: C0, C1, C3, C6-C10 (x86 only)
+        Count   residency[8];                               // 0x940 (x86_64), 0x340 (aarch64): Idle residency histogram: bucket n counts [4^n, 4^(n+1)) µs, the last one beyond
+
+        // Statistics page of the current CPU
+        static auto &cpu() { return *reinterpret_cast<Statistics *>(MMAP_CPU_STAT); }
+
+        static auto get (cpu_t c) { return *Kmem::loc_to_glob (c, &alias); }
+
+        static void set (cpu_t c, Statistics *s) { *Kmem::loc_to_glob (c, &alias) = s; }
+};
+
+static_assert (__is_standard_layout (Statistics) && sizeof (Statistics) <= PAGE_SIZE (0));
+static_assert (__builtin_offsetof (Statistics, vmexit) == 0x100);
+static_assert (__builtin_offsetof (Statistics, cstate) == 0x100 + 8 * Event::gst_arch);
@@ -35,4 +35,5 @@ enum class Status : unsigned
     BAD_DEV,
     MEM_OBJ,
     MEM_CAP,
+    PENDING,
 };
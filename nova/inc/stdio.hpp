@@ -26,6 +26,7 @@
 #include "lowlevel.hpp"
 #include "macros.hpp"
 #include "memory.hpp"
+#include "trace.hpp"
 
 static inline auto stackptr() { return reinterpret_cast<uintptr_t>(__builtin_frame_address (0)); }
 
@@ -33,6 +34,8 @@ static inline auto stackptr() { return reinterpret_cast<uintptr_t>(__builtin_fra
 do {                                                \
     if (EXPECT_FALSE ((trace_mask & (T)) == (T)))   \
         Console::print ("[%3ld] " format, static_cast<long>(((stackptr() - 1) & ~OFFS_MASK (0)) == MMAP_CPU_DSTK ? ACCESS_ONCE (Cpu::id) : ~0UL), ## __VA_ARGS__);   \
+    if (EXPECT_FALSE ((T) && (trace_ring_mask & (T)) == (T) && (Trace::mask & (T)) == (T)))    \
+        Trace::log (format, ## __VA_ARGS__);        \
 } while (0)
 
 #define panic(format,...)                           \
@@ -71,7 +74,7 @@ enum {
 };
 
 /*
- * Enabled trace events
+ * Enabled trace events (console)
  */
 constexpr auto trace_mask { TRACE_CPU       |
                             TRACE_FPU       |
@@ -91,3 +94,21 @@ constexpr auto trace_mask { TRACE_CPU       |
                             TRACE_ERROR     |
 #endif
                             0 };
+
+/*
+ * Trace events that Trace::mask can enable for the binary trace buffers at runtime
+ */
+constexpr auto trace_ring_mask { TRACE_FPU       |
+                                 TRACE_INTR      |
+                                 TRACE_TIMR      |
+                                 TRACE_VIRT      |
+                                 TRACE_SCHEDULE  |
+                                 TRACE_RCU       |
+                                 TRACE_CREATE    |
+                                 TRACE_DESTROY   |
+                                 TRACE_SYSCALL   |
+                                 TRACE_EXCEPTION |
+                                 TRACE_CONT      |
+                                 TRACE_KILL      |
+                                 TRACE_ERROR     |
+                                 0 };
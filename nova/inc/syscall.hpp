@@ -92,6 +92,10 @@ struct Sys_create_sc final : private Sys_abi
     inline uint8_t prio() const { return p3() >> 16 & BIT_RANGE (6, 0); }
 
     inline cos_t cos() const { return p3() >> 23 & BIT_RANGE (15, 0); }
+
+    inline uint16_t period() const { return p3() >> 39 & BIT_RANGE (15, 0); }
+
+    inline bool sporadic() const { return p3() & BIT64 (55); }
 };
 
 struct Sys_create_pt final : private Sys_abi
@@ -150,8 +154,25 @@ struct Sys_ctrl_sc final : private Sys_abi
 {
     inline Sys_ctrl_sc (Sys_regs &r) : Sys_abi (r) {}
 
+    inline bool migrate() const { return flags() & BIT (0); }
+
+    inline bool latency() const { return flags() & BIT (1); }
+
+    inline bool server() const { return flags() & BIT (2); }
+
+    inline bool stats() const { return flags() & BIT (3); }
+
     inline unsigned long sc() const { return p0() >> 8; }
 
+    inline unsigned long cpu() const { return p1(); }
+
+    inline uint32_t bound() const { return static_cast<uint32_t>(p2()); }
+
+    // The period takes effect when the CPU of the SC dispatches it next
+    inline uint16_t period() const { return p3() & BIT_RANGE (15, 0); }
+
+    inline bool sporadic() const { return p3() & BIT (16); }
+
     inline void set_time_ticks (uint64_t val) { p1() = val; }
 };
 
@@ -186,6 +207,12 @@ struct Sys_ctrl_hw final : private Sys_abi
     inline auto op() const { return flags(); }
 
     inline auto desc() const { return p0() >> 8; }
+
+    inline void set_load (unsigned r, uint64_t t) { p1() = r; p2() = t; }
+
+    inline void set_trace (uint64_t a, uint64_t l) { p1() = a; p2() = l; }
+
+    inline void set_mask (unsigned m) { p1() = m; }
 };
 
 struct Sys_assign_int final : private Sys_abi
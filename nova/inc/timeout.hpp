@@ -21,14 +21,26 @@
 #include "compiler.hpp"
 #include "types.hpp"
 
+/*
+ * Timeouts of a CPU are kept in a pairing heap ordered by expiry time.
+ * Enqueue is O(1), removal is O(log n) amortized, the root is the earliest.
+ *
+ * prev: parent (for the leftmost child) or left sibling, nullptr for the root
+ * next: right sibling
+ * chld: leftmost child
+ */
 class Timeout
 {
     private:
         uint64_t    time    { 0 };
         Timeout *   prev    { nullptr };
         Timeout *   next    { nullptr };
+        Timeout *   chld    { nullptr };
+
+        static Timeout *root CPULOCAL;
 
-        static Timeout *list CPULOCAL;
+        static Timeout *meld (Timeout *, Timeout *);
+        static Timeout *merge_pairs (Timeout *);
 
         virtual void trigger() = 0;
 
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include "atomic.hpp"
 #include "timeout.hpp"
 
 class Ec;
@@ -26,8 +27,8 @@ class Sm;
 class Timeout_hypercall final : public Timeout
 {
     private:
-        Ec * const  ec  { nullptr };
-        Sm *        sm  { nullptr };
+        Ec * const      ec  { nullptr };
+        Atomic<Sm *>    sm  { nullptr };
 
         void trigger() override;
 
@@ -35,4 +36,6 @@ class Timeout_hypercall final : public Timeout
         Timeout_hypercall (Ec *e) : ec (e) {}
 
         void enqueue (uint64_t t, Sm *s) { sm = s; Timeout::enqueue (t); }
+
+        void detach() { sm = nullptr; }
 };
@@ -0,0 +1,88 @@
+/*
+ * Binary Trace Buffer
+ *
+ * Copyright (C) 2019-2024 Udo Steinberg, BedRock Systems, Inc.
+ *
+ * This file is part of the NOVA microhypervisor.
+ *
+ * NOVA is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * NOVA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ */
+
+#pragma once
+
+#include "atomic.hpp"
+#include "compiler.hpp"
+#include "macros.hpp"
+#include "memory.hpp"
+#include "types.hpp"
+
+/*
+ * A trace record is written by its CPU only, with interrupts masked, and never
+ * spans a cache line.
+ *
+ * The record with index i is valid if i < w_idx and w_idx - i < entries,
+ * where w_idx must be read before and after copying the record. The writer
+ * publishes w_idx before it overwrites the slot of the oldest record, so a
+ * reader that observes the new contents also observes the new w_idx.
+ */
+class Trace_ring final
+{
+    public:
+        struct Record
+        {
+            uint64_t time;                                  // System time
+            uint64_t event;                                 // Virtual address of the format string
+            uint64_t arg[6];                                // Leading arguments of the format string
+        };
+
+        static_assert (sizeof (Record) == 64);
+
+        Atomic<uint64_t, __ATOMIC_RELAXED, __ATOMIC_RELEASE> w_idx { 0 };
+
+        static constexpr unsigned ord       { 3 };
+        static constexpr unsigned size      { BIT (PAGE_BITS + ord) };
+        static constexpr unsigned entries   { size / sizeof (Record) - 1 };
+
+        ALIGNED (sizeof (Record)) Record record[entries];
+
+        [[nodiscard]] static void *operator new (size_t) noexcept;
+};
+
+class Trace final
+{
+    private:
+        static Trace_ring *ring CPULOCAL;
+
+        static void write (char const *, uint64_t const *, unsigned);
+
+        template<typename T> static inline uint64_t arg (T *p) { return reinterpret_cast<uintptr_t>(p); }
+        template<typename T> static inline uint64_t arg (T  v) { return static_cast<uint64_t>(v); }
+
+    public:
+        // Trace events recorded into the trace buffers
+        static inline Atomic<unsigned> mask { 0 };
+
+        static void init();
+
+        static Trace_ring *buffer (cpu_t);
+
+        /*
+         * Record a trace event into the trace buffer of the current CPU
+         *
+         * @param f     Format string (identifies the event)
+         * @param a     Arguments of the format string (excess arguments are dropped)
+         */
+        template<typename... A> static void log (char const *f, A... a)
+        {
+            uint64_t const v[] { arg (a)..., 0 };
+
+            write (f, v, sizeof... (a));
+        }
+};
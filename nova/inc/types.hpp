@@ -21,6 +21,7 @@
 #pragma once
 
 // Signed Integer Types
+using int16_t   = __INT16_TYPE__;
 using int32_t   = __INT32_TYPE__;
 using int64_t   = __INT64_TYPE__;
 
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "buddy.hpp"
+#include "string.hpp"
 #include "utcb_arch.hpp"
 
 class Utcb final
@@ -35,10 +36,36 @@ class Utcb final
     public:
         inline auto arch() { return &state; }
 
+        /*
+         * Copy message registers to another UTCB
+         *
+         * Short messages are copied inline, because the startup cost of a string
+         * move exceeds a few word moves on CPUs without fast short REP MOV.
+         * Longer messages use the architecture-specific memcpy.
+         *
+         * @param mtd   Message transfer descriptor (number of words)
+         * @param dst   Destination UTCB
+         */
         inline void copy (Mtd_user const mtd, Utcb *dst) const
         {
-            for (unsigned i { 0 }; i < mtd.count(); i++)
-                dst->mr[i] = mr[i];
+            auto const n { mtd.count() };
+
+            if (EXPECT_TRUE (n <= 8))
+                for (unsigned i { 0 }; i < n; i++)
+                    dst->mr[i] = mr[i];
+            else
+                memcpy (dst->mr, mr, n * sizeof (*mr));
+        }
+
+        /*
+         * Store a kernel record in the message registers
+         *
+         * @param src   Source record
+         * @param size  Size of the record (in bytes), at most the size of the UTCB
+         */
+        inline void store (void const *src, size_t size)
+        {
+            memcpy (mr, src, size);
         }
 
         /*
@@ -0,0 +1,60 @@
+/*
+ * Bitmap Range Helpers
+ *
+ * Copyright (C) 2019-2024 Udo Steinberg, BedRock Systems, Inc.
+ *
+ * This file is part of the NOVA microhypervisor.
+ *
+ * NOVA is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * NOVA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ */
+
+#pragma once
+
+#include "atomic.hpp"
+#include "compiler.hpp"
+#include "util.hpp"
+
+class Bitmap
+{
+    protected:
+        static constexpr auto bits { 8 * sizeof (uintptr_t) };
+
+        /*
+         * Merge selectors into a bitmap word
+         *
+         * @param w     Bitmap word
+         * @param v     New value for the selectors
+         * @param m     Mask of the selectors being updated
+         */
+        static inline void merge (Atomic<uintptr_t> &w, uintptr_t v, uintptr_t m)
+        {
+            // Fast path: the word is replaced as a whole
+            if (EXPECT_TRUE (m == ~0UL))
+                w = v;
+
+            // Slow path: selectors outside the mask are shared with other ranges
+            else {
+                w &= v | ~m;
+                w |=  v &  m;
+            }
+        }
+
+        /*
+         * Compute the mask of selectors in the bitmap word of s that are below e
+         *
+         * @param s     Selector base
+         * @param e     Selector end
+         * @return      Selector mask
+         */
+        static constexpr uintptr_t rng (unsigned long s, unsigned long e)
+        {
+            return ~0UL >> (bits - min (e - s + s % bits, bits)) & ~0UL << s % bits;
+        }
+};
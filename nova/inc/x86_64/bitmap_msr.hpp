@@ -21,15 +21,13 @@
 
 #pragma once
 
-#include "atomic.hpp"
+#include "bitmap.hpp"
 #include "buddy.hpp"
-#include "compiler.hpp"
 
-class Bitmap_msr final
+class Bitmap_msr final : private Bitmap
 {
     private:
         static constexpr auto sels { BITN (13) };
-        static constexpr auto bits { 8 * sizeof (uintptr_t) };
 
         // MSR bitmap
         struct {
@@ -55,6 +53,23 @@ class Bitmap_msr final
         inline void set_w (unsigned long s)       {        sel_to_bmp_w (s) |=  msk (s); }
         inline bool tst_w (unsigned long s) const { return sel_to_bmp_w (s) &   msk (s); }
 
+        /*
+         * Update a selector range one bitmap word at a time
+         *
+         * @param s     Selector base
+         * @param n     Number of selectors (the range must not cross the end of the low or high MSR range)
+         * @param b     Source bitmap (or nullptr)
+         * @param r     True to deny read access to the entire range, false to inherit read access from the source bitmap
+         * @param w     True to deny write access to the entire range, false to inherit write access from the source bitmap
+         */
+        void update (unsigned long s, unsigned long n, Bitmap_msr const *b, bool r, bool w)
+        {
+            for (auto const e { s + n }; s < e; s += bits - s % bits) {
+                merge (sel_to_bmp_r (s), (b ? b->sel_to_bmp_r (s).load() : 0) | (r ? ~0UL : 0), rng (s, e));
+                merge (sel_to_bmp_w (s), (b ? b->sel_to_bmp_w (s).load() : 0) | (w ? ~0UL : 0), rng (s, e));
+            }
+        }
+
         /*
          * Allocate MSR bitmap
          *
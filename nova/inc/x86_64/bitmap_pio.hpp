@@ -21,15 +21,13 @@
 
 #pragma once
 
-#include "atomic.hpp"
+#include "bitmap.hpp"
 #include "buddy.hpp"
-#include "compiler.hpp"
 
-class Bitmap_pio final
+class Bitmap_pio final : private Bitmap
 {
     private:
         static constexpr auto sels { BITN (16) };
-        static constexpr auto bits { 8 * sizeof (uintptr_t) };
 
         // I/O Bitmap
         struct {
@@ -49,6 +47,20 @@ class Bitmap_pio final
         inline void set (unsigned long s)       {        sel_to_bmp (s) |=  msk (s); }
         inline bool tst (unsigned long s) const { return sel_to_bmp (s) &   msk (s); }
 
+        /*
+         * Update a selector range one bitmap word at a time
+         *
+         * @param s     Selector base
+         * @param n     Number of selectors
+         * @param b     Source bitmap (or nullptr)
+         * @param d     True to deny access to the entire range, false to inherit access from the source bitmap
+         */
+        void update (unsigned long s, unsigned long n, Bitmap_pio const *b, bool d)
+        {
+            for (auto const e { min (s + n, sels) }; s < e; s += bits - s % bits)
+                merge (sel_to_bmp (s), (b ? b->sel_to_bmp (s).load() : 0) | (d ? ~0UL : 0), rng (s, e));
+        }
+
         /*
          * Allocate PIO bitmap
          *
@@ -33,8 +33,6 @@ class Counter final
     public:
         static Counter req[NUM_IPI] CPULOCAL;
         static Counter loc[NUM_LVT] CPULOCAL;
-        static Counter schedule     CPULOCAL;
-        static Counter helping      CPULOCAL;
 
         ALWAYS_INLINE
         inline void inc()
@@ -53,8 +53,14 @@ class Cpu final
             C10 = 56,
         };
 
-        static uint32_t cstates CPULOCAL;
-        static uint64_t csthint CPULOCAL;
+        // Initial exit latency and target residency in µs of C0, C1, C3, C6, C7, C8, C9, C10
+        static constexpr struct cstate_param { uint16_t lat, res; }
+            cstparam[8] { { 0, 0 }, { 2, 1 }, { 70, 80 }, { 85, 120 }, { 124, 151 }, { 200, 256 }, { 480, 339 }, { 890, 1034 } };
+
+        static uint32_t cstates     CPULOCAL;
+        static uint64_t csthint     CPULOCAL;
+        static uint16_t cstlat[8]   CPULOCAL;   // Measured exit latency (1/8 µs) of the state each C-state is demoted to
+        static uint16_t cstcor      CPULOCAL;   // Moving average of actual/predicted idle residency (1/1024, at most 2)
 
         static auto supports (Cstate c) { return cstates >> std::to_underlying (c) / 2 & BIT_RANGE (3, 0); }
 
@@ -89,9 +95,11 @@ class Cpu final
             VMX                     =  0 * 32 +  5,     // Virtual Machine Extensions
             EIST                    =  0 * 32 +  7,     // Enhanced Intel SpeedStep Technology
             PCID                    =  0 * 32 + 17,     // Process Context Identifiers
+            SSE4_1                  =  0 * 32 + 19,     // SSE4.1 Instructions
             X2APIC                  =  0 * 32 + 21,     // x2APIC Support
             TSC_DEADLINE            =  0 * 32 + 24,     // TSC Deadline Support
             XSAVE                   =  0 * 32 + 26,     // XCR0, XSETBV/XGETBV/XSAVE/XRSTOR Instructions
+            AVX                     =  0 * 32 + 28,     // Advanced Vector Extensions
             RDRAND                  =  0 * 32 + 30,     // RDRAND Instruction
             // EAX=0x1 (EDX)
             MCE                     =  1 * 32 +  7,     // Machine Check Exception
@@ -118,6 +126,7 @@ class Cpu final
             RDT_A                   =  3 * 32 + 15,     // RDT Allocation (PQE)
             RDSEED                  =  3 * 32 + 18,     // RDSEED Instruction
             SMAP                    =  3 * 32 + 20,     // Supervisor Mode Access Prevention
+            SHA                     =  3 * 32 + 29,     // SHA Extensions
             // EAX=0x7 ECX=0x0 (ECX)
             UMIP                    =  4 * 32 +  2,     // User Mode Instruction Prevention
             CET_SS                  =  4 * 32 +  7,     // CET Shadow Stack
@@ -282,6 +291,9 @@ class Cpu final
         static inline cpu_t                 count  { 0 };
         static inline Atomic<cpu_t>         online { 0 };
 
+        // CPU-local data of all cores is accessible once they have passed the bootstrap barrier
+        static bool booted() { return online && online == count; }
+
         static void init();
         static void fini();
         static void halt();
@@ -302,6 +314,9 @@ class Cpu final
         static void preemption_enable()     { asm volatile ("sti" : : : "memory"); }
         static void preemption_point()      { asm volatile ("sti; nop; cli" : : : "memory"); }
 
+        static uintptr_t preemption_save()  { uintptr_t f; asm volatile ("pushf; pop %0; cli" : "=r" (f) : : "memory"); return f; }
+        static void preemption_restore (uintptr_t f) { if (f & RFL_IF) preemption_enable(); }
+
         static void cpuid (unsigned leaf, uint32_t &eax, uint32_t &ebx, uint32_t &ecx, uint32_t &edx)
         {
             asm volatile ("cpuid" : "=a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx) : "a" (leaf));
@@ -50,6 +50,9 @@ class Ec_arch final : private Ec
         void collect() override final
         {
             trace (TRACE_DESTROY, "KOBJ: EC %p collected", static_cast<void *>(this));
+
+            // CPU-local state refers to the EC, so it retires on its own CPU
+            defer (retire, cpu);
         }
 
         static void handle_exc (Exc_regs *) asm ("exc_handler");
@@ -67,6 +70,12 @@ class Ec_arch final : private Ec
 
         [[noreturn]] void vmx_extint();
 
+        bool vmx_rdmsr (uint32_t, uint64_t &) const;
+
+        bool vmx_wrmsr (uint32_t, uint64_t);
+
+        bool vmx_trivial (unsigned);
+
         ALWAYS_INLINE
         inline void redirect_to_iret()
         {
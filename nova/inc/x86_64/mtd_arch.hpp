@@ -59,6 +59,7 @@ class Mtd_arch final : public Mtd
             EFER            = BIT (25),
             KERNEL_GS_BASE  = BIT (26),
             TSC             = BIT (27),
+            EXIT            = BIT (28),
 
             TLB             = BIT (29),
             FPU             = BIT (30),
@@ -23,3 +23,4 @@
 #define PATCH_XSAVES    0
 #define PATCH_CET_IBT   1
 #define PATCH_CET_SSS   2
+#define PATCH_ERMS      3
@@ -18,24 +18,51 @@
 #pragma once
 
 #include "atomic.hpp"
+#include "bits.hpp"
 #include "macros.hpp"
 #include "types.hpp"
 
 class Pcid final
 {
     private:
+        static constexpr auto tags { BIT (12) };
+
+        // Spaces beyond the tag space share the last tag and flush it on every switch
+        static constexpr uint16_t shared { tags - 1 };
+
         uint16_t const val;
 
-        static inline Atomic<uint16_t> allocator { 0 };
+        static inline Atomic<uint64_t> used[tags / 64] { 0 };
+
+        /*
+         * Allocate the lowest free tag (tags of destroyed spaces are reused)
+         *
+         * @return      Tag
+         */
+        static inline uint16_t alloc()
+        {
+            for (unsigned i { 0 }; i < tags / 64; i++)
+                for (uint64_t f; (f = ~used[i]); ) {
+                    auto const b { static_cast<unsigned>(bit_scan_forward (f)) };
+                    if (!used[i].test_and_set (BIT64 (b)))
+                        return static_cast<uint16_t>(i * 64 + b);
+                }
+
+            return shared;
+        }
 
-        // FIXME: Handle overflow
-        static inline auto alloc()
+        static inline void free (uint16_t t)
         {
-            return allocator++;
+            if (t != shared)
+                used[t / 64] &= ~BIT64 (t % 64);
         }
 
     public:
         inline Pcid() : val (alloc()) {}
 
+        inline ~Pcid() { free (val); }
+
+        inline bool is_shared() const { return val == shared; }
+
         inline operator auto() const { return val & BIT_RANGE (11, 0); }
 };
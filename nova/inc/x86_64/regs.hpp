@@ -72,7 +72,7 @@ struct Exc_regs
         };
         struct {
             uint64_t    offset_tsc;
-            uintptr_t   reserved;
+            uintptr_t   knl_exit;
             uintptr_t   shadow_cr0;
             uintptr_t   shadow_cr4;
             uintptr_t   intcpt_cr0;
@@ -122,6 +122,7 @@ class alignas (16) Cpu_regs final
         Refptr<Space_pio>       pio     { nullptr };
         Refptr<Space_msr>       msr     { nullptr };
         Hazard                  hazard  { 0 };
+        uint32_t                vpid_gen { 0 }; // VPID generation (VMX only)
 
         Cpu_regs (Refptr<Space_obj> &o, Refptr<Space_hst> &h, Refptr<Space_pio> &p) : vmcb { nullptr }, obj { std::move (o) }, hst { std::move (h) }, pio { std::move (p) } {}
         Cpu_regs (Refptr<Space_obj> &o, Refptr<Space_hst> &h, Vmcb *v) : vmcb { v }, obj { std::move (o) }, hst { std::move (h) }, hazard (Hazard::ILLEGAL) {}
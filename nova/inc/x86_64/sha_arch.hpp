@@ -0,0 +1,36 @@
+/*
+ * Secure Hash Algorithm (SHA): Architecture-Specific Part (x86)
+ *
+ * Copyright (C) 2019-2024 Udo Steinberg, BedRock Systems, Inc.
+ *
+ * This file is part of the NOVA microhypervisor.
+ *
+ * NOVA is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * NOVA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ */
+
+#pragma once
+
+#include "compiler.hpp"
+#include "hash.hpp"
+
+/*
+ * The kernel is compiled for general-purpose registers only. The block functions
+ * below use SIMD registers and must therefore only run while the kernel owns the FPU.
+ */
+class Sha_arch final
+{
+    private:
+        TARGET ("sha,sse4.1") static void sha1 (uint32_t *, uint8_t const *, size_t);
+        TARGET ("sha,sse4.1") static void sha2 (uint32_t *, uint8_t const *, size_t);
+        TARGET ("avx")        static void sha2 (uint64_t *, uint64_t *, uint8_t const *, size_t);
+
+    public:
+        static bool init();
+};
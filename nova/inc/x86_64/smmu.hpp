@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include "atomic.hpp"
+#include "bits.hpp"
 #include "buddy.hpp"
 #include "cache.hpp"
 #include "lapic.hpp"
@@ -69,6 +71,7 @@ class Smmu final : public List<Smmu>
         {
             ESRTPS      = 63,               // Enhanced Set Root Table Pointer Support
             ESIRTPS     = 62,               // Enhanced Set Interrupt Remap Table Pointer Support
+            PSI         = 39,               // Page Selective Invalidation
             PHMR        =  6,               // Protected Hi Memory Region
             PLMR        =  5,               // Protected Lo Memory Region
         };
@@ -165,6 +168,8 @@ class Smmu final : public List<Smmu>
             Inv_dsc_tlb() : Inv_dsc (Type::TLB, std::to_underlying (Gran::GLOBAL) << 4) {}
 
             Inv_dsc_tlb (uint16_t did) : Inv_dsc (Type::TLB, static_cast<uint64_t>(did) << 16 | std::to_underlying (Gran::DOMAIN) << 4) {}
+
+            Inv_dsc_tlb (uint16_t did, uint64_t addr, unsigned am) : Inv_dsc (Type::TLB, static_cast<uint64_t>(did) << 16 | std::to_underlying (Gran::PAGE) << 4, addr | am) {}
         };
 
         static_assert (__is_standard_layout (Inv_dsc_tlb) && sizeof (Inv_dsc_tlb) == sizeof (Inv_dsc));
@@ -256,6 +261,9 @@ class Smmu final : public List<Smmu>
         uint64_t            cap;
         uint64_t            ecap;
         unsigned            invq_idx            { 0 };
+        unsigned            invq_hdx            { 0 };
+        Atomic<uint32_t>    invq_seq            { 0 };
+        Atomic<uint32_t>    invq_ack            { 0 };
         Inv_dsc *           invq                { nullptr };
         Spinlock            inv_lock;
 
@@ -274,6 +282,7 @@ class Smmu final : public List<Smmu>
         bool feature (Ecap e) const { return ecap & BIT64 (std::to_underlying (e)); }
 
         auto nfr() const { return static_cast<unsigned>(cap >> 40 & BIT_RANGE (7, 0)) + 1; }
+        auto mam() const { return static_cast<unsigned>(cap >> 48 & BIT_RANGE (5, 0)); }
         auto fro() const { return static_cast<unsigned>(cap >> 20 & BIT_RANGE (13, 4)); }
         auto iro() const { return static_cast<unsigned>(ecap >> 4 & BIT_RANGE (13, 4)); }
 
@@ -306,23 +315,56 @@ class Smmu final : public List<Smmu>
         }
 
         /*
-         * QI: Invalidation
+         * QI: Queue descriptor without notifying hardware
+         *
+         * @return      True if the descriptor was queued, false if no slot became free in time
          */
-        void qi_post (Inv_dsc const &q)
+        [[nodiscard]] bool qi_post (Inv_dsc const &q)
         {
+            auto const idx { (invq_idx + 1) % cnt };
+
+            // If the queue appears full, then hand the pending descriptors to hardware and wait for a free slot
+            if (EXPECT_FALSE (idx == invq_hdx)) {
+                write (Reg64::IQT, invq_idx << 4);
+                if (EXPECT_FALSE (!Wait::until (timeout, [&] { return idx != (invq_hdx = static_cast<unsigned>(read (Reg64::IQH) >> 4)); })))
+                    return false;
+            }
+
             invq[invq_idx] = q;
-            invq_idx = (invq_idx + 1) % cnt;
-            write (Reg64::IQT, invq_idx << 4);
+            invq_idx = idx;
+
+            return true;
         }
 
         /*
-         * QI: Wait for completion
+         * QI: Submit all queued descriptors as one batch, terminated by a wait descriptor
+         *
+         * When the batch has completed, hardware writes its sequence number (invq_seq) to invq_ack.
+         *
+         * @return      True if the batch was submitted, false if the wait descriptor could not be queued
          */
-        [[nodiscard]] bool qi_wait() const
+        [[nodiscard]] bool qi_submit()
         {
-            auto const v { read (Reg64::IQT) };
+            auto const seq { invq_seq + 1 };
+
+            if (EXPECT_FALSE (!qi_post (Inv_dsc_iwt (Kmem::ptr_to_phys (&invq_ack), seq))))
+                return false;
+
+            invq_seq = seq;
+
+            write (Reg64::IQT, invq_idx << 4);
 
-            return Wait::until (timeout, [&] { return read (Reg64::IQH) == v; });
+            return true;
+        }
+
+        /*
+         * QI: Wait for completion of a batch
+         *
+         * @param seq   Sequence number of the batch (completes all earlier batches as well)
+         */
+        [[nodiscard]] bool qi_wait (uint32_t seq) const
+        {
+            return Wait::until (timeout, [&] { return static_cast<int32_t>(invq_ack - seq) >= 0; });
         }
 
         /*
@@ -361,6 +403,17 @@ class Smmu final : public List<Smmu>
             return ri_wait_tlb();
         }
 
+        /*
+         * RI: TLB Invalidation (Page-Selective within Domain)
+         */
+        [[nodiscard]] bool ri_inv_tlb (uint16_t did, uint64_t addr, unsigned am) const
+        {
+            write (Tlb64::IVA, addr | am);
+            write (Tlb64::IOTLB, BIT64 (63) | static_cast<uint64_t>(Inv_dsc_tlb::Gran::PAGE) << 60 | static_cast<uint64_t>(did) << 32);
+
+            return ri_wait_tlb();
+        }
+
         /*
          * RI: CTX Invalidation (Global)
          */
@@ -401,24 +454,41 @@ class Smmu final : public List<Smmu>
             if (EXPECT_FALSE (!feature (Ecap::QI)))
                 return ri_inv_tlb();
 
-            qi_post (Inv_dsc_tlb());
-
-            return qi_wait();
+            return qi_post (Inv_dsc_tlb()) && qi_submit() && qi_wait (invq_seq);
         }
 
         /*
-         * TLB Invalidation (Domain-Selective)
+         * TLB Invalidation (Page-Selective or Domain-Selective) without waiting for completion
+         *
+         * A naturally aligned region of up to 2^MAMV pages is invalidated with one page-selective
+         * descriptor, larger regions with a domain-selective descriptor.
+         *
+         * @param did   Domain ID
+         * @param b     Region base address
+         * @param e     Region end address
+         * @return      True if the invalidation was submitted (QI) or completed (RI), false otherwise
          */
-        bool invalidate_tlb (uint16_t did)
+        bool invalidate_tlb (uint16_t did, uint64_t b, uint64_t e)
         {
+            // Smallest naturally aligned region that covers [b, e)
+            auto const o { static_cast<unsigned>(bit_scan_reverse (b ^ (e - 1)) + 1) };
+            auto const a { b & ~(BIT64 (o) - 1) };
+            auto const p { feature (Cap::PSI) && o - PAGE_BITS <= mam() };
+
             Lock_guard <Spinlock> guard { inv_lock };
 
             if (EXPECT_FALSE (!feature (Ecap::QI)))
-                return ri_inv_tlb (did);
+                return p ? ri_inv_tlb (did, a, o - PAGE_BITS) : ri_inv_tlb (did);
 
-            qi_post (Inv_dsc_tlb (did));
+            return qi_post (p ? Inv_dsc_tlb (did, a, o - PAGE_BITS) : Inv_dsc_tlb (did)) && qi_submit();
+        }
 
-            return qi_wait();
+        /*
+         * TLB Invalidation: Wait for completion of all submitted batches
+         */
+        bool invalidate_tlb_wait() const
+        {
+            return qi_wait (invq_seq);
         }
 
         /*
@@ -431,10 +501,7 @@ class Smmu final : public List<Smmu>
             if (EXPECT_FALSE (!feature (Ecap::QI)))
                 return ri_inv_ctx() && ri_inv_tlb();
 
-            qi_post (Inv_dsc_ctx());
-            qi_post (Inv_dsc_tlb());
-
-            return qi_wait();
+            return qi_post (Inv_dsc_ctx()) && qi_post (Inv_dsc_tlb()) && qi_submit() && qi_wait (invq_seq);
         }
 
         /*
@@ -447,10 +514,7 @@ class Smmu final : public List<Smmu>
             if (EXPECT_FALSE (!feature (Ecap::QI)))
                 return ri_inv_ctx (did) && ri_inv_tlb (did);
 
-            qi_post (Inv_dsc_ctx (did));
-            qi_post (Inv_dsc_tlb (did));
-
-            return qi_wait();
+            return qi_post (Inv_dsc_ctx (did)) && qi_post (Inv_dsc_tlb (did)) && qi_submit() && qi_wait (invq_seq);
         }
 
         /*
@@ -463,10 +527,7 @@ class Smmu final : public List<Smmu>
             if (EXPECT_FALSE (!feature (Ecap::QI)))
                 return ri_inv_ctx (sid, did) && ri_inv_tlb (did);
 
-            qi_post (Inv_dsc_ctx (sid, did));
-            qi_post (Inv_dsc_tlb (did));
-
-            return qi_wait();
+            return qi_post (Inv_dsc_ctx (sid, did)) && qi_post (Inv_dsc_tlb (did)) && qi_submit() && qi_wait (invq_seq);
         }
 
         /*
@@ -478,9 +539,7 @@ class Smmu final : public List<Smmu>
 
             Lock_guard <Spinlock> guard { inv_lock };
 
-            qi_post (Inv_dsc_iec());
-
-            return qi_wait();
+            return qi_post (Inv_dsc_iec()) && qi_submit() && qi_wait (invq_seq);
         }
 
         /*
@@ -492,9 +551,7 @@ class Smmu final : public List<Smmu>
 
             Lock_guard <Spinlock> guard { inv_lock };
 
-            qi_post (Inv_dsc_iec (idx));
-
-            return qi_wait();
+            return qi_post (Inv_dsc_iec (idx)) && qi_submit() && qi_wait (invq_seq);
         }
 
         /*
@@ -551,11 +608,33 @@ class Smmu final : public List<Smmu>
                 l->init();
         }
 
-        ALWAYS_INLINE
-        static inline void invalidate_tlb_all (Sdid did)
+        /*
+         * TLB Invalidation on all SMMUs
+         *
+         * The invalidations are submitted to all SMMUs before waiting for any of them.
+         *
+         * @param did   Domain ID
+         * @param b     Region base address
+         * @param e     Region end address
+         * @param wait  Wait for completion (true) or let the invalidations retire in the background (false)
+         * @return      True if all invalidations were submitted (and completed if waiting), false otherwise
+         */
+        [[nodiscard]] static bool invalidate_tlb_all (Sdid did, uint64_t b, uint64_t e, bool wait)
         {
+            if (EXPECT_FALSE (b >= e))
+                return true;
+
+            bool ok { true };
+
             for (auto l { list }; l; l = l->next)
-                l->invalidate_tlb (did);
+                ok &= l->invalidate_tlb (did, b, e);
+
+            // Waiting for the latest batch also covers batches that other cores submitted in the meantime
+            if (wait)
+                for (auto l { list }; l; l = l->next)
+                    ok &= l->invalidate_tlb_wait();
+
+            return ok;
         }
 
         ALWAYS_INLINE
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "cmdline.hpp"
 #include "ptab_dpt.hpp"
 #include "smmu.hpp"
 #include "space_mem.hpp"
@@ -38,6 +39,8 @@ class Space_dma final : public Space_mem<Space_dma>
         void collect() override final
         {
             trace (TRACE_DESTROY, "KOBJ: DMA %p collected", static_cast<void *>(this));
+
+            defer (reclaim<Space_dma>);
         }
 
     public:
@@ -87,9 +90,16 @@ class Space_dma final : public Space_mem<Space_dma>
             operator delete (this, cache);
         }
 
-        auto update (uint64_t v, uint64_t p, unsigned o, Paging::Permissions pm, Memattr ma) { return dptp.update (v, p, o, pm, ma); }
+        auto update (uint64_t v, uint64_t p, unsigned o, Paging::Permissions pm, Memattr ma) { Lock_guard <Spinlock> guard { lock }; return dptp.update (v, p, o, pm, ma); }
+
+        void promote (uint64_t v, unsigned o) { Lock_guard <Spinlock> guard { lock }; dptp.promote (v, o); }
 
-        void sync() { Smmu::invalidate_tlb_all (sdid); }
+        /*
+         * Invalidate DMA translations for a region after a mapping change
+         *
+         * In lazy mode, the invalidation retires in the background unless page-table memory is waiting to be freed.
+         */
+        bool sync (uintptr_t b, uintptr_t e) { return Smmu::invalidate_tlb_all (sdid, b, e, !Cmdline::lazydma || Buddy::waiting()); }
 
         auto get_sdid() const { return sdid; }
 
@@ -31,11 +31,21 @@ class Space_gst final : public Space_mem<Space_gst>
     private:
         Eptp    eptp;
 
-        Space_gst (Refptr<Pd> &p) : Space_mem { Kobject::Subtype::GST, p } {}
+        // A recycled root may still be cached under the same EPTP, so flush it on first use
+        Space_gst (Refptr<Pd> &p) : Space_mem { Kobject::Subtype::GST, p } { gtlb.set(); }
+
+        ~Space_gst()
+        {
+            eptp.destroy();
+
+            Buddy::free_wait();
+        }
 
         void collect() override final
         {
             trace (TRACE_DESTROY, "KOBJ: GST %p collected", static_cast<void *>(this));
+
+            defer (reclaim<Space_gst>);
         }
 
     public:
@@ -85,9 +95,11 @@ class Space_gst final : public Space_mem<Space_gst>
 
         auto lookup (uint64_t v, uint64_t &p, unsigned &o, Memattr &ma) const { return eptp.lookup (v, p, o, ma); }
 
-        auto update (uint64_t v, uint64_t p, unsigned o, Paging::Permissions pm, Memattr ma) { return eptp.update (v, p, o, pm, ma); }
+        auto update (uint64_t v, uint64_t p, unsigned o, Paging::Permissions pm, Memattr ma) { Lock_guard <Spinlock> guard { lock }; return eptp.update (v, p, o, pm, ma); }
+
+        void promote (uint64_t v, unsigned o) { Lock_guard <Spinlock> guard { lock }; eptp.promote (v, o); }
 
-        void sync() { gtlb.set(); Tlb::shootdown (this); }
+        bool sync (uintptr_t, uintptr_t) { gtlb.set(); return Tlb::shootdown (this); }
 
         void invalidate() { eptp.invalidate(); }
 
@@ -33,11 +33,18 @@ class Space_hst final : public Space_mem<Space_hst>
     private:
         Space_hst();
 
-        Space_hst (Refptr<Pd> &p) : Space_mem { Kobject::Subtype::HST, p } {}
+        // A recycled PCID may still tag stale TLB entries on any CPU
+        Space_hst (Refptr<Pd> &p) : Space_mem { Kobject::Subtype::HST, p } { htlb.set(); }
+
+        ~Space_hst();
 
         void collect() override final
         {
             trace (TRACE_DESTROY, "KOBJ: HST %p collected", static_cast<void *>(this));
+
+            get_pd()->detach (this);
+
+            defer (reclaim<Space_hst>);
         }
 
     public:
@@ -48,6 +55,8 @@ class Space_hst final : public Space_mem<Space_hst>
         Cpuset      cpus;
         Cpuset      htlb;
 
+        Atomic<unsigned> inflight { 0 };        // Shootdowns in progress
+
         static Space_hst nova;
         static Space_hst *current CPULOCAL;
 
@@ -97,9 +106,12 @@ class Space_hst final : public Space_mem<Space_hst>
 
         auto lookup (uint64_t v, uint64_t &p, unsigned &o, Memattr &ma) const { return hptp.lookup (v, p, o, ma); }
 
-        auto update (uint64_t v, uint64_t p, unsigned o, Paging::Permissions pm, Memattr ma) { return hptp.update (v, p, o, pm, ma); }
+        auto update (uint64_t v, uint64_t p, unsigned o, Paging::Permissions pm, Memattr ma) { Lock_guard <Spinlock> guard { lock }; return hptp.update (v, p, o, pm, ma); }
+
+        void promote (uint64_t v, unsigned o) { Lock_guard <Spinlock> guard { lock }; hptp.promote (v, o); }
 
-        void sync() { htlb.set(); Tlb::shootdown (this); }
+        // An unacknowledged shootdown stays in flight, which keeps remote CPUs from invalidating page-selectively
+        bool sync (uintptr_t b, uintptr_t e) { inflight++; htlb.set(); if (!Tlb::shootdown (this, b, e)) return false; inflight--; return true; }
 
         ALWAYS_INLINE
         inline void make_current()
@@ -114,7 +126,8 @@ class Space_hst final : public Space_mem<Space_hst>
                 if (EXPECT_TRUE (current == this))
                     return;
 
-                p |= BIT64 (63);
+                if (EXPECT_TRUE (!pcid.is_shared()))
+                    p |= BIT64 (63);
             }
 
             current = this;
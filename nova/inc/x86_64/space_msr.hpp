@@ -83,9 +83,9 @@ class Space_msr final : public Space
         void collect() override final
         {
             trace (TRACE_DESTROY, "KOBJ: MSR %p collected", static_cast<void *>(this));
-        }
 
-        [[nodiscard]] Paging::Permissions lookup (unsigned long) const;
+            defer (reclaim<Space_msr>);
+        }
 
         void update (unsigned long, Paging::Permissions);
 
@@ -51,11 +51,11 @@ class Space_pio final : public Space
         void collect() override final
         {
             trace (TRACE_DESTROY, "KOBJ: PIO %p collected", static_cast<void *>(this));
-        }
 
-        [[nodiscard]] Paging::Permissions lookup (unsigned long) const;
+            get_pd()->detach (this);
 
-        void update (unsigned long, Paging::Permissions);
+            defer (reclaim<Space_pio>);
+        }
 
     public:
         [[nodiscard]] Status delegate (Space_pio const *, unsigned long, unsigned long, unsigned, unsigned);
@@ -104,9 +104,5 @@ class Space_pio final : public Space
             operator delete (this, cache);
         }
 
-        static void access_ctrl (uint64_t base, size_t size, Paging::Permissions perm)
-        {
-            for (unsigned i { 0 }; i < size; i++)       // FIXME: Optimize
-                nova.update (base + i, perm);
-        }
+        static void access_ctrl (uint64_t base, size_t size, Paging::Permissions perm) { nova.bmp->update (base, size, nullptr, !(perm & Paging::R)); }
 };
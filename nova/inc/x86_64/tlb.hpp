@@ -21,10 +21,43 @@
 
 #pragma once
 
+#include "atomic.hpp"
+#include "compiler.hpp"
+#include "config.hpp"
+#include "spinlock.hpp"
+#include "types.hpp"
+
 class Space;
 
 class Tlb final
 {
+    private:
+        static constexpr unsigned max_pages { 32 };     // Ceiling for page-selective invalidation
+
+        /*
+         * Per-CPU shootdown mailbox
+         *
+         * Initiators merge the invalidated range into the mailbox of each
+         * target CPU and take the bumped "req" as their ticket. The target
+         * consumes the mailbox in its RKE handler and publishes the consumed
+         * "req" in "ack" afterwards. A request has been handled once "ack"
+         * has reached its ticket. Fewer than 2^15 requests can be pending at
+         * a target, because each CPU has at most one pending request there.
+         */
+        struct Mailbox
+        {
+            Spinlock            lock;
+            Space *             space;
+            uintptr_t           base, limit;
+            unsigned            ops;
+            Atomic<uint16_t>    req, ack;
+        };
+
+        static Mailbox  mbox            CPULOCAL;
+        static uint16_t tkt[NUM_CPU]    CPULOCAL;      // Tickets of this CPU in the mailboxes of the targets
+
     public:
-        static void shootdown (Space *);
+        [[nodiscard]] static bool shootdown (Space *, uintptr_t = 0, uintptr_t = ~0UL);
+
+        static void handler();
 };
@@ -50,7 +50,7 @@ class Utcb_arch final
         uint64_t        r8,  r9,  r10, r11, r12, r13, r14, r15;
         uint64_t        rfl, rip;
         uint32_t        inst_len, inst_info, intr_state, actv_state;
-        uint64_t        qual[3], reserved;
+        uint64_t        qual[3], knl_exit;
         uint32_t        ctrl_pri, ctrl_sec;
         uint64_t        ctrl_ter;
         uint64_t        intcpt_cr0, intcpt_cr4;
@@ -72,6 +72,18 @@ class Utcb_arch final
         bool assign_spaces (Cpu_regs &, Space_obj const *) const;
 
     public:
+        /*
+         * In-kernel exit policy: VM exits that the kernel completes without a VMM round trip
+         */
+        enum Exit : uint64_t
+        {
+            RDTSC           = BIT (0),      // RDTSC
+            RDTSCP          = BIT (1),      // RDTSCP
+            PAUSE           = BIT (2),      // PAUSE
+            XSETBV          = BIT (3),      // XSETBV of XCR0
+            MSR             = BIT (4),      // RDMSR/WRMSR of SYSCALL, SYSENTER, KERNEL_GS_BASE, TSC_AUX
+        };
+
         void load_exc (Mtd_arch const, Exc_regs const &);
         void load_vmx (Mtd_arch const, Cpu_regs const &);
         void load_svm (Mtd_arch const, Cpu_regs const &);
@@ -530,13 +530,14 @@ class Vmcs final
             VMX_EPT_VIOLATION       = 48,
             VMX_EPT_MISCONFIG       = 49,
             VMX_INVEPT              = 50,
+            VMX_RDTSCP              = 51,
             VMX_PREEMPT             = 52,
             VMX_INVVPID             = 53,
             VMX_WBINVD              = 54,
             VMX_XSETBV              = 55,
         };
 
-        void init (uintptr_t, uintptr_t, uintptr_t, uint64_t, uint16_t);
+        void init (uintptr_t, uintptr_t, uintptr_t, uint64_t);
 
         ALWAYS_INLINE
         inline void clear()
@@ -20,8 +20,8 @@
 
 #pragma once
 
-#include "atomic.hpp"
-#include "kmem.hpp"
+#include "compiler.hpp"
+#include "types.hpp"
 
 class Invvpid final
 {
@@ -45,13 +45,46 @@ class Invvpid final
 class Vpid final
 {
     private:
-        static Atomic<uint16_t> allocator CPULOCAL;
+        static uint16_t next    CPULOCAL;       // Next tag of the current generation
+        static uint32_t gen     CPULOCAL;       // Current generation
 
     public:
-        // FIXME: Handle overflow
-        static inline auto alloc (cpu_t cpu)
+        /*
+         * Start a new generation of tags on the current CPU
+         *
+         * All tags are flushed. Each vCPU obtains a new tag before its next VM entry,
+         * which also recycles the tags of destroyed vCPUs.
+         */
+        static inline void rollover()
         {
-            return ++*Kmem::loc_to_glob (cpu, &allocator);
+            next = 1;   // VPID 0 is reserved for the host
+            gen++;
+
+            invalidate (Invvpid::Type::ALL, 0);
+        }
+
+        /*
+         * Determine if a tag belongs to the current generation
+         *
+         * @param g     Generation of the tag
+         * @return      True if the tag is still valid, false otherwise
+         */
+        static inline bool valid (uint32_t g) { return g == gen; }
+
+        /*
+         * Allocate a tag of the current generation (on the CPU of the vCPU)
+         *
+         * @param g     Generation of the tag (updated)
+         * @return      Tag
+         */
+        static inline uint16_t alloc (uint32_t &g)
+        {
+            if (EXPECT_FALSE (!next))
+                rollover();
+
+            g = gen;
+
+            return next++;
         }
 
         static inline void invalidate (Invvpid::Type t, uint16_t vpid, uint64_t addr = 0)
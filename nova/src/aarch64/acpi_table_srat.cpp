@@ -16,6 +16,7 @@
  */
 
 #include "acpi_table_srat.hpp"
+#include "numa.hpp"
 #include "stdio.hpp"
 
 void Acpi_table_srat::Affinity_memory::parse() const
@@ -25,6 +26,8 @@ void Acpi_table_srat::Affinity_memory::parse() const
         return;
 
     trace (TRACE_FIRM, "SRAT: %#018lx-%018lx Dom %u", uint64_t { base }, base + size, uint32_t { pxd });
+
+    Numa::add_memory (base, size, pxd);
 }
 
 void Acpi_table_srat::parse() const
@@ -19,5 +19,3 @@
 
 Counter Counter::req[Intid::NUM_SGI];
 Counter Counter::loc[Intid::NUM_PPI];
-Counter Counter::schedule;
-Counter Counter::helping;
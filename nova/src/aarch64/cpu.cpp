@@ -24,8 +24,10 @@
 #include "gich.hpp"
 #include "gicr.hpp"
 #include "ptab_npt.hpp"
+#include "statistics.hpp"
 #include "stdio.hpp"
 #include "timer.hpp"
+#include "trace.hpp"
 #include "vmcb.hpp"
 
 bool Cpu::bsp;
@@ -273,6 +275,7 @@ void Cpu::init (cpu_t cpu, unsigned e)
     Gich::init();
 
     Timer::init();
+    Trace::init();
 
     Nptp::init();
     Vmcb::init();
@@ -319,10 +322,14 @@ void Cpu::set_vmm_regs (uintptr_t (&x)[31], uint64_t &hcr, uint64_t &vpidr, uint
 
 void Cpu::allocate (cpu_t cpu, uint64_t m, uint64_t r)
 {
+    if (EXPECT_FALSE (cpu >= NUM_CPU))
+        panic ("Platform has more than %u CPUs", NUM_CPU);
+
     auto const c { Buddy::alloc (0, Buddy::Fill::BITS0) };  // CPU-Local Data
     auto const d { Buddy::alloc (0, Buddy::Fill::BITS0) };  // Data Stack
+    auto const s { Buddy::alloc (0, Buddy::Fill::BITS0) };  // Statistics
 
-    if (EXPECT_FALSE (!c || !d))
+    if (EXPECT_FALSE (!c || !d || !s))
         panic ("CPU allocation failed");
 
     Hptp hptp { 0 };
@@ -330,9 +337,10 @@ void Cpu::allocate (cpu_t cpu, uint64_t m, uint64_t r)
     // Share kernel code and data
     hptp.share_from_master (LINK_ADDR);
 
-    // Map cpu-local data and stack
+    // Map cpu-local data, stack and statistics
     hptp.update (MMAP_CPU_DATA, Kmem::ptr_to_phys (c), 0, Paging::Permissions (Paging::G | Paging::W | Paging::R), Memattr::ram());
     hptp.update (MMAP_CPU_DSTK, Kmem::ptr_to_phys (d), 0, Paging::Permissions (Paging::G | Paging::W | Paging::R), Memattr::ram());
+    hptp.update (MMAP_CPU_STAT, Kmem::ptr_to_phys (s), 0, Paging::Permissions (Paging::G | Paging::W | Paging::R), Memattr::ram());
 
     // Add to CPU array
     Hptp::master_map (MMAP_GLB_CPUS + cpu * PAGE_SIZE (0), Kmem::ptr_to_phys (c), 0, Paging::Permissions (Paging::G | Paging::W | Paging::R), Memattr::ram());
@@ -341,4 +349,6 @@ void Cpu::allocate (cpu_t cpu, uint64_t m, uint64_t r)
     *Kmem::loc_to_glob (cpu, &mpidr) = m;
     *Kmem::loc_to_glob (cpu, &gicr)  = r;
     *Kmem::loc_to_glob (cpu, &ptab)  = hptp.root_addr();
+
+    Statistics::set (cpu, static_cast<Statistics *>(s));
 }
@@ -46,7 +46,7 @@ Ec_arch::Ec_arch (bool t, Fpu *f, Refptr<Space_obj> &ref_obj, Refptr<Space_hst>
     exc_regs().set_ep (Event::hst_arch + Event::Selector::STARTUP);
 
     // Map UTCB
-    hst->update (hva, Kmem::ptr_to_phys (kpage), 0, Paging::Permissions (Paging::K | Paging::U | Paging::W | Paging::R), Memattr::ram());
+    hst->update (kmap = hva, Kmem::ptr_to_phys (kpage), 0, Paging::Permissions (Paging::K | Paging::U | Paging::W | Paging::R), Memattr::ram());
 }
 
 // Constructor: GST EC
@@ -93,31 +93,66 @@ Ec *Ec::create_gst (Status &s, Pd *pd, bool t, bool fpu, cpu_t cpu, unsigned lon
     return nullptr;
 }
 
+/*
+ * Destroy an EC (runs on the CPU of the EC)
+ */
+void Ec::destroy()
+{
+    auto const hst { regs.get_hst() };
+
+    if (fpu)
+        Fpu::operator delete (fpu, hst->get_pd()->fpu_cache);
+
+    // The UTCB is freed with the host space if it is still mapped there
+    if (kpage) {
+
+        uint64_t p; unsigned o; Memattr ma;
+
+        if (!(hst->lookup (kmap, p, o, ma) & Paging::K) || p != Kmem::ptr_to_phys (kpage))
+            Buddy::free (kpage);
+    }
+
+    if (is_vcpu()) {
+
+        if (Vmcb::current == regs.vmcb)
+            Vmcb::load_hst();
+
+        delete regs.vmcb;
+    }
+
+    this->~Ec();
+
+    operator delete (this, cache);
+}
+
 void Ec::adjust_offset_ticks (uint64_t t)
 {
     if (subtype == Kobject::Subtype::EC_VCPU_OFFS)
         regs.vmcb->tmr.cntvoff += t;
 }
 
-void Ec::handle_hazard (unsigned h, cont_t func)
+void Ec::handle_hazard (unsigned h, cont_t resume)
 {
     if (h & Hazard::RCU)
         Rcu::quiet();
 
-    if (EXPECT_FALSE (h & (Hazard::ILLEGAL | Hazard::RECALL | Hazard::SLEEP | Hazard::SCHED))) {
+    if (EXPECT_FALSE (h & (Hazard::ILLEGAL | Hazard::RECALL | Hazard::HOME | Hazard::SLEEP | Hazard::SCHED))) {
 
         Cpu::preemption_point();
 
         if (Cpu::hazard & Hazard::SLEEP) {      // Reload
-            cont = func;
+            cont = resume;
             Cpu::fini();
         }
 
         if (Cpu::hazard & Hazard::SCHED) {      // Reload
-            cont = func;
+            cont = resume;
             Scheduler::schedule();
         }
 
+        if (regs.hazard & Hazard::HOME)         // Reload
+            return_home (resume);
+
         if (h & Hazard::ILLEGAL)
             kill ("Illegal execution state");
 
@@ -125,7 +160,7 @@ void Ec::handle_hazard (unsigned h, cont_t func)
 
             regs.hazard.clr (Hazard::RECALL);
 
-            if (func == Ec_arch::ret_user_vmexit) {
+            if (resume == Ec_arch::ret_user_vmexit) {
                 exc_regs().set_ep (Event::gst_arch + Event::Selector::RECALL);
                 send_msg<Ec_arch::ret_user_vmexit> (this);
             } else {
@@ -143,7 +178,7 @@ void Ec::handle_hazard (unsigned h, cont_t func)
 
 void Ec_arch::ret_user_hypercall (Ec *const self)
 {
-    auto const h { (Cpu::hazard ^ self->regs.hazard) & (Hazard::ILLEGAL | Hazard::RECALL | Hazard::FPU | Hazard::RCU | Hazard::SLEEP | Hazard::SCHED) };
+    auto const h { (Cpu::hazard ^ self->regs.hazard) & (Hazard::ILLEGAL | Hazard::RECALL | Hazard::HOME | Hazard::FPU | Hazard::RCU | Hazard::SLEEP | Hazard::SCHED) };
     if (EXPECT_FALSE (h))
         self->handle_hazard (h, ret_user_hypercall);
 
@@ -22,6 +22,7 @@
 #include "interrupt.hpp"
 #include "pd.hpp"
 #include "smc.hpp"
+#include "statistics.hpp"
 #include "stdio.hpp"
 #include "vmcb.hpp"
 
@@ -55,8 +56,11 @@ void Ec_arch::handle_exc_user (Exc_regs *r)
     bool resolved { false };
 
     // SVC #0 from AArch64 state
-    if (EXPECT_TRUE (esr == (VAL_SHIFT (0x15, 26) | BIT (25) | 0)))
-        (*syscall[r->sys.gpr[0] & BIT_RANGE (3, 0)])(self);
+    if (EXPECT_TRUE (esr == (VAL_SHIFT (0x15, 26) | BIT (25) | 0))) {
+        auto const n { r->sys.gpr[0] & BIT_RANGE (3, 0) };
+        Statistics::cpu().syscall[n].inc();
+        (*syscall[n])(self);
+    }
 
     // SVC #1 from AArch64 state
     else if (esr == (VAL_SHIFT (0x15, 26) | BIT (25) | 1))
@@ -69,10 +73,14 @@ void Ec_arch::handle_exc_user (Exc_regs *r)
     trace (TRACE_EXCEPTION, "EC:%p %s %#lx at M:%#x IP:%#lx", static_cast<void *>(self), self->is_vcpu() ? "VMX" : "EXC", r->ep(), r->mode(), r->el2.elr);
 
     if (self->is_vcpu()) {
+        Statistics::cpu().vmexit[r->ep()].inc();
         self->regs.vmcb->save_gst();
         resolved ? ret_user_vmexit (self) : send_msg<ret_user_vmexit> (self);
-    } else
+    } else {
+        if (r->ep() == 0x20 || r->ep() == 0x24)     // Instruction or Data Abort
+            Statistics::cpu().page_fault.inc();
         resolved ? ret_user_exception (self) : send_msg<ret_user_exception> (self);
+    }
 }
 
 void Ec_arch::handle_irq_kern()
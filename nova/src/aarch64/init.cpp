@@ -56,6 +56,9 @@ extern "C" unsigned init()
 
     Acpi::init() || Fdt::init();
 
+    if (!Acpi::resume)
+        Buddy::partition();
+
     // If SMMUs were not enumerated by firmware, then enumerate them based on board knowledge
     if (!Smmu::avail_smg() && !Smmu::avail_ctx())
         for (unsigned i = 0; i < sizeof (Board::smmu) / sizeof (*Board::smmu); i++)
@@ -0,0 +1,288 @@
+/*
+ * Secure Hash Algorithm (SHA): Architecture-Specific Part (ARM)
+ *
+ * Copyright (C) 2019-2024 Udo Steinberg, BedRock Systems, Inc.
+ *
+ * This file is part of the NOVA microhypervisor.
+ *
+ * NOVA is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * NOVA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ */
+
+#include "cpu.hpp"
+#include "sha_arch.hpp"
+#include "stdio.hpp"
+
+/*
+ * SHA-1: 4 rounds for group W with constant K
+ *
+ * v0: A, B, C, D  v1: E  v5: E for this group  v6: E for the next group
+ */
+#define SHA1(OP, W, K)          "add        v4.4s,  v" #W ".4s, v" #K ".4s  ;"  \
+                                "sha1h      s6,     s0                  ;"      \
+                                "sha1" #OP "      q0,     s5,     v4.4s           ;"  \
+                                "mov        v5.16b, v6.16b              ;"
+
+#define SHA1_SU(W, X, Y, Z)     "sha1su0    v" #W ".4s, v" #X ".4s, v" #Y ".4s ;"   \
+                                "sha1su1    v" #W ".4s, v" #Z ".4s      ;"
+
+/*
+ * SHA-256: 4 rounds for group W with constant K
+ *
+ * v0: A, B, C, D  v1: E, F, G, H
+ */
+#define SHA256(W, K)            "add        v4.4s,  v" #W ".4s, v" #K ".4s  ;"  \
+                                "mov        v6.16b, v0.16b              ;"      \
+                                "sha256h    q0,     q1,     v4.4s       ;"      \
+                                "sha256h2   q1,     q6,     v4.4s       ;"
+
+#define SHA256_SU(W, X, Y, Z)   "sha256su0  v" #W ".4s, v" #X ".4s      ;"      \
+                                "sha256su1  v" #W ".4s, v" #Y ".4s, v" #Z ".4s ;"
+
+/*
+ * SHA-512: 2 rounds for message pair W
+ *
+ * The working variables (A, B), (C, D), (E, F), (G, H) rotate through v0-v4
+ */
+#define SHA512(I0, I1, I2, I3, I4, W)                                           \
+                                "ld1        {v5.2d}, [%[k]], #16        ;"      \
+                                "add        v5.2d,  v5.2d,  v" #W ".2d  ;"      \
+                                "ext        v6.16b, v" #I2 ".16b, v" #I3 ".16b, #8 ;"   \
+                                "ext        v5.16b, v5.16b, v5.16b, #8  ;"      \
+                                "ext        v7.16b, v" #I1 ".16b, v" #I2 ".16b, #8 ;"   \
+                                "add        v" #I3 ".2d, v" #I3 ".2d, v5.2d ;"  \
+                                "sha512h    q" #I3 ", q6, v7.2d         ;"      \
+                                "add        v" #I4 ".2d, v" #I1 ".2d, v" #I3 ".2d ;"    \
+                                "sha512h2   q" #I3 ", q" #I1 ", v" #I0 ".2d ;"
+
+#define SHA512_SU(W, W1, W4, W5, W7)                                            \
+                                "ext        v5.16b, v" #W4 ".16b, v" #W5 ".16b, #8 ;"   \
+                                "sha512su0  v" #W ".2d, v" #W1 ".2d     ;"      \
+                                "sha512su1  v" #W ".2d, v" #W7 ".2d, v5.2d ;"
+
+/*
+ * SHA-1 with the cryptographic extension (FEAT_SHA1)
+ */
+void Sha_arch::sha1 (uint32_t *h, uint8_t const *m, size_t n)
+{
+    if (!n)
+        return;
+
+    asm volatile (".arch_extension sha2                     ;"
+                  "dup        v16.4s, %w[k0]              ;"
+                  "dup        v17.4s, %w[k1]              ;"
+                  "dup        v18.4s, %w[k2]              ;"
+                  "dup        v19.4s, %w[k3]              ;"
+                  "ld1        {v0.4s}, [%[h]]             ;"
+                  "ldr        s1,     [%[h], #16]         ;"
+                  "1:                                     ;"
+                  "ld1        {v8.16b-v11.16b}, [%[m]], #64 ;"
+                  "rev32      v8.16b,  v8.16b             ;"
+                  "rev32      v9.16b,  v9.16b             ;"
+                  "rev32      v10.16b, v10.16b            ;"
+                  "rev32      v11.16b, v11.16b            ;"
+                  "mov        v2.16b, v0.16b              ;"
+                  "mov        v5.16b, v1.16b              ;"
+                  SHA1 (c,  8, 16) SHA1_SU ( 8,  9, 10, 11)
+                  SHA1 (c,  9, 16) SHA1_SU ( 9, 10, 11,  8)
+                  SHA1 (c, 10, 16) SHA1_SU (10, 11,  8,  9)
+                  SHA1 (c, 11, 16) SHA1_SU (11,  8,  9, 10)
+                  SHA1 (c,  8, 16) SHA1_SU ( 8,  9, 10, 11)
+                  SHA1 (p,  9, 17) SHA1_SU ( 9, 10, 11,  8)
+                  SHA1 (p, 10, 17) SHA1_SU (10, 11,  8,  9)
+                  SHA1 (p, 11, 17) SHA1_SU (11,  8,  9, 10)
+                  SHA1 (p,  8, 17) SHA1_SU ( 8,  9, 10, 11)
+                  SHA1 (p,  9, 17) SHA1_SU ( 9, 10, 11,  8)
+                  SHA1 (m, 10, 18) SHA1_SU (10, 11,  8,  9)
+                  SHA1 (m, 11, 18) SHA1_SU (11,  8,  9, 10)
+                  SHA1 (m,  8, 18) SHA1_SU ( 8,  9, 10, 11)
+                  SHA1 (m,  9, 18) SHA1_SU ( 9, 10, 11,  8)
+                  SHA1 (m, 10, 18) SHA1_SU (10, 11,  8,  9)
+                  SHA1 (p, 11, 19) SHA1_SU (11,  8,  9, 10)
+                  SHA1 (p,  8, 19)
+                  SHA1 (p,  9, 19)
+                  SHA1 (p, 10, 19)
+                  SHA1 (p, 11, 19)
+                  "add        v0.4s,  v0.4s,  v2.4s       ;"
+                  "add        v1.2s,  v1.2s,  v5.2s       ;"
+                  "subs       %[n],   %[n],   #1          ;"
+                  "b.ne       1b                          ;"
+                  "st1        {v0.4s}, [%[h]]             ;"
+                  "str        s1,     [%[h], #16]         ;"
+                  : [m] "+r" (m), [n] "+r" (n)
+                  : [h] "r" (h), [k0] "r" (0x5a827999), [k1] "r" (0x6ed9eba1), [k2] "r" (0x8f1bbcdc), [k3] "r" (0xca62c1d6)
+                  : "cc", "memory", "v0", "v1", "v2", "v4", "v5", "v6", "v8", "v9", "v10", "v11", "v16", "v17", "v18", "v19");
+}
+
+/*
+ * SHA-256 with the cryptographic extension (FEAT_SHA256)
+ */
+void Sha_arch::sha2 (uint32_t *h, uint8_t const *m, size_t n)
+{
+    struct K { uint32_t v[64]; };
+
+    static constexpr K k { [] { K r { }; for (unsigned i { 0 }; i < 64; i++) r.v[i] = static_cast<uint32_t>(Sha::cbr[i] >> 32); return r; }() };
+
+    if (!n)
+        return;
+
+    auto p { k.v };
+
+    asm volatile (".arch_extension sha2                     ;"
+                  "ld1        {v16.4s-v19.4s}, [%[k]], #64 ;"
+                  "ld1        {v20.4s-v23.4s}, [%[k]], #64 ;"
+                  "ld1        {v24.4s-v27.4s}, [%[k]], #64 ;"
+                  "ld1        {v28.4s-v31.4s}, [%[k]]     ;"
+                  "ld1        {v0.4s-v1.4s}, [%[h]]       ;"
+                  "1:                                     ;"
+                  "ld1        {v8.16b-v11.16b}, [%[m]], #64 ;"
+                  "rev32      v8.16b,  v8.16b             ;"
+                  "rev32      v9.16b,  v9.16b             ;"
+                  "rev32      v10.16b, v10.16b            ;"
+                  "rev32      v11.16b, v11.16b            ;"
+                  "mov        v2.16b, v0.16b              ;"
+                  "mov        v3.16b, v1.16b              ;"
+                  SHA256 ( 8, 16) SHA256_SU ( 8,  9, 10, 11)
+                  SHA256 ( 9, 17) SHA256_SU ( 9, 10, 11,  8)
+                  SHA256 (10, 18) SHA256_SU (10, 11,  8,  9)
+                  SHA256 (11, 19) SHA256_SU (11,  8,  9, 10)
+                  SHA256 ( 8, 20) SHA256_SU ( 8,  9, 10, 11)
+                  SHA256 ( 9, 21) SHA256_SU ( 9, 10, 11,  8)
+                  SHA256 (10, 22) SHA256_SU (10, 11,  8,  9)
+                  SHA256 (11, 23) SHA256_SU (11,  8,  9, 10)
+                  SHA256 ( 8, 24) SHA256_SU ( 8,  9, 10, 11)
+                  SHA256 ( 9, 25) SHA256_SU ( 9, 10, 11,  8)
+                  SHA256 (10, 26) SHA256_SU (10, 11,  8,  9)
+                  SHA256 (11, 27) SHA256_SU (11,  8,  9, 10)
+                  SHA256 ( 8, 28)
+                  SHA256 ( 9, 29)
+                  SHA256 (10, 30)
+                  SHA256 (11, 31)
+                  "add        v0.4s,  v0.4s,  v2.4s       ;"
+                  "add        v1.4s,  v1.4s,  v3.4s       ;"
+                  "subs       %[n],   %[n],   #1          ;"
+                  "b.ne       1b                          ;"
+                  "st1        {v0.4s-v1.4s}, [%[h]]       ;"
+                  : [m] "+r" (m), [n] "+r" (n), [k] "+r" (p)
+                  : [h] "r" (h)
+                  : "cc", "memory", "v0", "v1", "v2", "v3", "v4", "v6", "v8", "v9", "v10", "v11",
+                    "v16", "v17", "v18", "v19", "v20", "v21", "v22", "v23", "v24", "v25", "v26", "v27", "v28", "v29", "v30", "v31");
+}
+
+/*
+ * SHA-512 with the cryptographic extension (FEAT_SHA512)
+ */
+void Sha_arch::sha2 (uint64_t *h, uint8_t const *m, size_t n)
+{
+    if (!n)
+        return;
+
+    uint64_t const *p;
+
+    asm volatile (".arch_extension sha3                     ;"
+                  "ld1        {v8.2d-v11.2d}, [%[h]]      ;"
+                  "1:                                     ;"
+                  "ld1        {v12.16b-v15.16b}, [%[m]], #64 ;"
+                  "ld1        {v16.16b-v19.16b}, [%[m]], #64 ;"
+                  "rev64      v12.16b, v12.16b            ;"
+                  "rev64      v13.16b, v13.16b            ;"
+                  "rev64      v14.16b, v14.16b            ;"
+                  "rev64      v15.16b, v15.16b            ;"
+                  "rev64      v16.16b, v16.16b            ;"
+                  "rev64      v17.16b, v17.16b            ;"
+                  "rev64      v18.16b, v18.16b            ;"
+                  "rev64      v19.16b, v19.16b            ;"
+                  "mov        v0.16b, v8.16b              ;"
+                  "mov        v1.16b, v9.16b              ;"
+                  "mov        v2.16b, v10.16b             ;"
+                  "mov        v3.16b, v11.16b             ;"
+                  "mov        %[k],   %[c]                ;"
+                  SHA512 (0, 1, 2, 3, 4, 12) SHA512_SU (12, 13, 16, 17, 19)
+                  SHA512 (3, 0, 4, 2, 1, 13) SHA512_SU (13, 14, 17, 18, 12)
+                  SHA512 (2, 3, 1, 4, 0, 14) SHA512_SU (14, 15, 18, 19, 13)
+                  SHA512 (4, 2, 0, 1, 3, 15) SHA512_SU (15, 16, 19, 12, 14)
+                  SHA512 (1, 4, 3, 0, 2, 16) SHA512_SU (16, 17, 12, 13, 15)
+                  SHA512 (0, 1, 2, 3, 4, 17) SHA512_SU (17, 18, 13, 14, 16)
+                  SHA512 (3, 0, 4, 2, 1, 18) SHA512_SU (18, 19, 14, 15, 17)
+                  SHA512 (2, 3, 1, 4, 0, 19) SHA512_SU (19, 12, 15, 16, 18)
+                  SHA512 (4, 2, 0, 1, 3, 12) SHA512_SU (12, 13, 16, 17, 19)
+                  SHA512 (1, 4, 3, 0, 2, 13) SHA512_SU (13, 14, 17, 18, 12)
+                  SHA512 (0, 1, 2, 3, 4, 14) SHA512_SU (14, 15, 18, 19, 13)
+                  SHA512 (3, 0, 4, 2, 1, 15) SHA512_SU (15, 16, 19, 12, 14)
+                  SHA512 (2, 3, 1, 4, 0, 16) SHA512_SU (16, 17, 12, 13, 15)
+                  SHA512 (4, 2, 0, 1, 3, 17) SHA512_SU (17, 18, 13, 14, 16)
+                  SHA512 (1, 4, 3, 0, 2, 18) SHA512_SU (18, 19, 14, 15, 17)
+                  SHA512 (0, 1, 2, 3, 4, 19) SHA512_SU (19, 12, 15, 16, 18)
+                  SHA512 (3, 0, 4, 2, 1, 12) SHA512_SU (12, 13, 16, 17, 19)
+                  SHA512 (2, 3, 1, 4, 0, 13) SHA512_SU (13, 14, 17, 18, 12)
+                  SHA512 (4, 2, 0, 1, 3, 14) SHA512_SU (14, 15, 18, 19, 13)
+                  SHA512 (1, 4, 3, 0, 2, 15) SHA512_SU (15, 16, 19, 12, 14)
+                  SHA512 (0, 1, 2, 3, 4, 16) SHA512_SU (16, 17, 12, 13, 15)
+                  SHA512 (3, 0, 4, 2, 1, 17) SHA512_SU (17, 18, 13, 14, 16)
+                  SHA512 (2, 3, 1, 4, 0, 18) SHA512_SU (18, 19, 14, 15, 17)
+                  SHA512 (4, 2, 0, 1, 3, 19) SHA512_SU (19, 12, 15, 16, 18)
+                  SHA512 (1, 4, 3, 0, 2, 12) SHA512_SU (12, 13, 16, 17, 19)
+                  SHA512 (0, 1, 2, 3, 4, 13) SHA512_SU (13, 14, 17, 18, 12)
+                  SHA512 (3, 0, 4, 2, 1, 14) SHA512_SU (14, 15, 18, 19, 13)
+                  SHA512 (2, 3, 1, 4, 0, 15) SHA512_SU (15, 16, 19, 12, 14)
+                  SHA512 (4, 2, 0, 1, 3, 16) SHA512_SU (16, 17, 12, 13, 15)
+                  SHA512 (1, 4, 3, 0, 2, 17) SHA512_SU (17, 18, 13, 14, 16)
+                  SHA512 (0, 1, 2, 3, 4, 18) SHA512_SU (18, 19, 14, 15, 17)
+                  SHA512 (3, 0, 4, 2, 1, 19) SHA512_SU (19, 12, 15, 16, 18)
+                  SHA512 (2, 3, 1, 4, 0, 12)
+                  SHA512 (4, 2, 0, 1, 3, 13)
+                  SHA512 (1, 4, 3, 0, 2, 14)
+                  SHA512 (0, 1, 2, 3, 4, 15)
+                  SHA512 (3, 0, 4, 2, 1, 16)
+                  SHA512 (2, 3, 1, 4, 0, 17)
+                  SHA512 (4, 2, 0, 1, 3, 18)
+                  SHA512 (1, 4, 3, 0, 2, 19)
+                  "add        v8.2d,  v8.2d,  v0.2d       ;"
+                  "add        v9.2d,  v9.2d,  v1.2d       ;"
+                  "add        v10.2d, v10.2d, v2.2d       ;"
+                  "add        v11.2d, v11.2d, v3.2d       ;"
+                  "subs       %[n],   %[n],   #1          ;"
+                  "b.ne       1b                          ;"
+                  "st1        {v8.2d-v11.2d}, [%[h]]      ;"
+                  : [m] "+r" (m), [n] "+r" (n), [k] "=&r" (p)
+                  : [h] "r" (h), [c] "r" (Sha::cbr)
+                  : "cc", "memory", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v8", "v9",
+                    "v10", "v11", "v12", "v13", "v14", "v15", "v16", "v17", "v18", "v19");
+}
+
+/*
+ * Select the block functions for the features of this CPU
+ *
+ * @return      True if any selected function uses SIMD registers, false otherwise
+ */
+bool Sha_arch::init()
+{
+    bool simd { false };
+
+    if (Cpu::feature (Cpu::Isa_feature::SHA1) >= 1) {
+        Sha::block<uint32_t>[0] = sha1;
+        simd = true;
+    }
+
+    if (Cpu::feature (Cpu::Isa_feature::SHA2) >= 1) {
+        Sha::block<uint32_t>[1] = sha2;
+        simd = true;
+    }
+
+    if (Cpu::feature (Cpu::Isa_feature::SHA2) >= 2) {
+        Sha::block<uint64_t>[1] = sha2;
+        simd = true;
+    }
+
+    trace (TRACE_CPU, "SHA: SHA-1:%s SHA-256:%s SHA-512:%s", Cpu::feature (Cpu::Isa_feature::SHA1) >= 1 ? "CE" : "GPR",
+                                                             Cpu::feature (Cpu::Isa_feature::SHA2) >= 1 ? "CE" : "GPR",
+                                                             Cpu::feature (Cpu::Isa_feature::SHA2) >= 2 ? "CE" : "GPR");
+
+    return simd;
+}
@@ -109,7 +109,7 @@ void Smmu::init()
 bool Smmu::conf_smg (uint8_t smg)
 {
     // Obtain SMG configuration
-    auto const dma { config->entry[smg].dma };
+    Space_dma *const dma { config->entry[smg].dma };
     auto const sid { config->entry[smg].sid };
     auto const msk { config->entry[smg].msk };
     auto const ctx { config->entry[smg].ctx };
@@ -164,10 +164,16 @@ bool Smmu::configure (Space_dma *dma, uintptr_t dad)
 
     trace (TRACE_SMMU, "SMMU: SID:%#06x MSK:%#06x SMG:%#04x CTX:%#04x assigned to Domain %u", sid, msk, smg, ctx, static_cast<unsigned>(dma->get_sdid()));
 
+    Refptr<Space_dma> ref { dma };
+
+    // Domain is being destroyed
+    if (EXPECT_FALSE (!ref))
+        return false;
+
     Lock_guard <Spinlock> guard { cfg_lock };
 
     // Remember SMG configuration for suspend/resume
-    config->entry[smg].dma = dma;
+    config->entry[smg].dma = std::move (ref);
     config->entry[smg].sid = sid;
     config->entry[smg].msk = msk;
     config->entry[smg].ctx = ctx;
@@ -0,0 +1,92 @@
+/*
+ * String Functions: Architecture-Specific Part (ARM)
+ *
+ * Copyright (C) 2019-2024 Udo Steinberg, BedRock Systems, Inc.
+ *
+ * This file is part of the NOVA microhypervisor.
+ *
+ * NOVA is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * NOVA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ */
+
+#include "macros.hpp"
+#include "string.hpp"
+
+/*
+ * The kernel runs with strict alignment, so words are only accessed at naturally aligned addresses.
+ * Source and destination with the same alignment are copied with paired 8-byte loads/stores.
+ */
+extern "C" void *memcpy (void *d, void const *s, size_t n)
+{
+    auto dst { static_cast<char *>(d) };
+    auto src { static_cast<char const *>(s) };
+
+    if (!((reinterpret_cast<uintptr_t>(dst) ^ reinterpret_cast<uintptr_t>(src)) & 7)) {
+
+        for (; n && reinterpret_cast<uintptr_t>(dst) & 7; n--)
+            *dst++ = *src++;
+
+        if (auto k { n / 16 }; k) {
+
+            uint64_t x, y;
+
+            asm volatile ("1:   ldp     %0, %1, [%3], #16   ;"
+                          "     stp     %0, %1, [%2], #16   ;"
+                          "     subs    %4, %4, #1          ;"
+                          "     b.ne    1b                  ;"
+                          : "=&r" (x), "=&r" (y), "+r" (dst), "+r" (src), "+r" (k) : : "cc", "memory");
+
+            n %= 16;
+        }
+    }
+
+    while (n--)
+        *dst++ = *src++;
+
+    return d;
+}
+
+/*
+ * Zeroing uses DC ZVA for whole blocks unless prohibited, filling uses aligned 8-byte stores.
+ */
+extern "C" void *memset (void *d, int c, size_t n)
+{
+    auto dst { static_cast<char *>(d) };
+    auto const v { static_cast<uint8_t>(c) * 0x0101010101010101UL };
+
+    for (; n && reinterpret_cast<uintptr_t>(dst) & 7; n--)
+        *dst++ = static_cast<char>(c);
+
+    if (!v) {
+
+        uint64_t dczid;
+
+        asm volatile ("mrs %0, dczid_el0" : "=r" (dczid));
+
+        // DZP clear: DC ZVA zeroes naturally aligned blocks of 4 << BS bytes
+        if (!(dczid & BIT (4))) {
+
+            auto const bs { 4UL << (dczid & BIT_RANGE (3, 0)) };
+
+            for (; n >= 8 && reinterpret_cast<uintptr_t>(dst) & (bs - 1); n -= 8, dst += 8)
+                asm volatile ("str xzr, [%0]" : : "r" (dst) : "memory");
+
+            for (; n >= bs; n -= bs, dst += bs)
+                asm volatile ("dc zva, %0" : : "r" (dst) : "memory");
+        }
+    }
+
+    for (; n >= 8; n -= 8, dst += 8)
+        asm volatile ("str %1, [%0]" : : "r" (dst), "r" (v) : "memory");
+
+    while (n--)
+        *dst++ = static_cast<char>(c);
+
+    return d;
+}
@@ -22,13 +22,38 @@
 #include "assert.hpp"
 #include "bits.hpp"
 #include "buddy.hpp"
+#include "cpu.hpp"
 #include "extern.hpp"
 #include "kmem.hpp"
 #include "lock_guard.hpp"
 #include "multiboot.hpp"
+#include "statistics.hpp"
+#include "stdio.hpp"
 #include "string.hpp"
 
 Buddy::Waitlist Buddy::waitlist;
+Buddy::Cache    Buddy::cache;
+
+/*
+ * Determine if blocks of an order go through the per-core block cache
+ *
+ * @param o         Block order
+ * @return          True if the block cache is used, false otherwise
+ */
+bool Buddy::cached (order_t o)
+{
+    return o < Cache::orders && Cpu::booted();
+}
+
+/*
+ * Determine the home node of this core
+ *
+ * @return          Node from which this core allocates first
+ */
+unsigned Buddy::home()
+{
+    return Cpu::booted() ? Numa::node : 0;
+}
 
 /*
  * Initialize the buddy allocator
@@ -49,21 +74,60 @@ void Buddy::init()
 }
 
 /*
- * Allocate physically and virtually contiguous memory region
+ * Partition the memory pool into per-node zones
  *
- * @param ord       Block order (2^ord pages)
- * @param fill      Fill pattern for the block
- * @return          Pointer to virtual memory region or nullptr if unsuccessful
+ * Until now all blocks belonged to the zone of node 0. Zone boundaries are rounded
+ * to the maximum block size, so that a block and its buddy never straddle two zones.
+ * Must be called before any other core allocates memory.
  */
-void *Buddy::alloc (order_t ord, Fill fill)
+void Buddy::partition()
 {
-    Lock_guard <Spinlock> guard { lock };
+    if (Numa::count == 1)
+        return;
+
+    constexpr index_t chunk { BIT (orders - 1) };
+
+    // Assign each maximum-order chunk of the pool to the node of its first page
+    for (auto i { align_dn (min_idx, chunk) }; i < max_idx; i += chunk) {
+
+        auto const s { max (i, min_idx) }, e { min (i + chunk, max_idx) };
+        auto const n { static_cast<uint8_t>(Numa::node_by_phys (Kmem::ptr_to_phys (reinterpret_cast<void *>(index_to_page (s))))) };
+
+        for (auto j { s }; j < e; j++)
+            index_to_block (j)->node = n;
+    }
+
+    // Move all free blocks into the zone of their node
+    for (order_t o { 0 }; o < orders; o++) {
+
+        Waitlist list;
 
+        for (Block *b; (b = zone[0].freelist.dequeue (o)); list.enqueue (b)) ;
+
+        for (Block *b; (b = list.dequeue()); zone[b->node].freelist.enqueue (b)) {
+            zone[0].pages         -= BIT (o);
+            zone[b->node].pages   += BIT (o);
+        }
+    }
+
+    for (unsigned n { 0 }; n < Numa::count; n++)
+        trace (TRACE_MEMORY, "ZONE: Node %u: %lu KiB free", n, available (n) >> 10);
+}
+
+/*
+ * Split a free block from the freelist of a zone (zone lock must be held)
+ *
+ * @param z         Zone
+ * @param ord       Block order (2^ord pages)
+ * @return          Pointer to the block or nullptr if unsuccessful
+ */
+Buddy::Block *Buddy::split (Zone &z, order_t ord)
+{
     // Iterate over all freelists, starting with the requested order
     for (auto o { ord }; o < orders; o++) {
 
         // Get the first block from the order(o) freelist
-        auto const block { freelist.dequeue (o) };
+        auto const block { z.freelist.dequeue (o) };
 
         // If that freelist was empty, try higher orders
         if (!block)
@@ -73,20 +137,39 @@ void *Buddy::alloc (order_t ord, Fill fill)
         while (o-- != ord) {
             auto const buddy { block + BIT (o) };
             assert (buddy->ord == o);
-            freelist.enqueue (buddy);
+            z.freelist.enqueue (buddy);
         }
 
         // Set final block size and mark block as used
         block->ord = ord;
         block->tag = Block::Tag::USED;
 
-        auto const ptr { reinterpret_cast<void *>(index_to_page (block_to_index (block))) };
+        z.pages -= BIT (ord);
+
+        return block;
+    }
+
+    // Out of memory
+    return nullptr;
+}
+
+/*
+ * Take a free block, starting with the specified node and falling back to remote nodes
+ *
+ * @param node      Preferred node
+ * @param ord       Block order (2^ord pages)
+ * @return          Pointer to the block or nullptr if unsuccessful
+ */
+Buddy::Block *Buddy::take (unsigned node, order_t ord)
+{
+    for (unsigned i { 0 }; i < Numa::count; i++) {
+
+        auto &z { zone[(node + i) % Numa::count] };
 
-        // Fill the block if requested
-        if (fill != Fill::NONE)
-            memset (ptr, fill == Fill::BITS0 ? 0 : ~0U, BIT (block->ord + PAGE_BITS));
+        Lock_guard <Spinlock> guard { z.lock };
 
-        return ptr;
+        if (auto const block { split (z, ord) }; block)
+            return block;
     }
 
     // Out of memory
@@ -94,17 +177,94 @@ void *Buddy::alloc (order_t ord, Fill fill)
 }
 
 /*
- * Coalesce to-be-freed block
+ * Refill the per-core cache with a batch of blocks from the home zone (zone lock must be held)
+ *
+ * @param ord       Block order
+ */
+void Buddy::refill (order_t ord)
+{
+    for (unsigned i { 0 }; i < Cache::batch; i++) {
+
+        auto const block { split (zone[Numa::node], ord) };
+
+        if (EXPECT_FALSE (!block))
+            break;
+
+        cache.enqueue (block);
+    }
+}
+
+/*
+ * Drain a batch of blocks from an overfull per-core cache into the home zone (zone lock must be held)
+ *
+ * @param ord       Block order
+ */
+void Buddy::drain (order_t ord)
+{
+    if (EXPECT_TRUE (cache.count (ord) <= Cache::limit))
+        return;
+
+    while (cache.count (ord) > Cache::limit - Cache::batch)
+        coalesce (cache.dequeue (ord));
+}
+
+/*
+ * Allocate physically and virtually contiguous memory region
+ *
+ * @param ord       Block order (2^ord pages)
+ * @param fill      Fill pattern for the block
+ * @return          Pointer to virtual memory region or nullptr if unsuccessful
+ */
+void *Buddy::alloc (order_t ord, Fill fill)
+{
+    Block *block { nullptr };
+
+    if (EXPECT_TRUE (cached (ord))) {
+
+        // Only take the zone lock if the per-core cache ran empty
+        if (EXPECT_FALSE (!cache.count (ord))) {
+            Lock_guard <Spinlock> guard { zone[Numa::node].lock };
+            refill (ord);
+        }
+
+        block = cache.dequeue (ord);
+    }
+
+    // Uncached order or home zone exhausted
+    if (!block)
+        block = take (home(), ord);
+
+    // Out of memory
+    if (EXPECT_FALSE (!block))
+        return nullptr;
+
+    if (EXPECT_TRUE (Cpu::booted()))
+        Statistics::cpu().buddy_alloc.inc();
+
+    auto const ptr { reinterpret_cast<void *>(index_to_page (block_to_index (block))) };
+
+    // Fill the block if requested
+    if (fill != Fill::NONE)
+        memset (ptr, fill == Fill::BITS0 ? 0 : ~0U, BIT (block->ord + PAGE_BITS));
+
+    return ptr;
+}
+
+/*
+ * Coalesce to-be-freed block (lock of the block's zone must be held)
  *
  * @param block     Pointer to the block
  */
 void Buddy::coalesce (Block *block)
 {
-    Lock_guard <Spinlock> guard { lock };
-
     // Ensure block was used
     assert (block->tag == Block::Tag::USED);
 
+    auto &z { zone[block->node] };
+
+    // Account for the freed pages
+    z.pages += BIT (block->ord);
+
     // Mark block as free
     block->tag = Block::Tag::FREE;
 
@@ -124,8 +284,11 @@ void Buddy::coalesce (Block *block)
         if (buddy->tag != Block::Tag::FREE || buddy->ord != o)
             break;
 
+        // Buddies always belong to the same zone
+        assert (buddy->node == block->node);
+
         // Dequeue buddy from the freelist
-        freelist.dequeue (buddy);
+        z.freelist.dequeue (buddy);
 
         // Merge block with buddy
         if (block > buddy)
@@ -133,7 +296,7 @@ void Buddy::coalesce (Block *block)
     }
 
     // Put final-size block into the freelist
-    freelist.enqueue (block);
+    z.freelist.enqueue (block);
 }
 
 /*
@@ -151,8 +314,31 @@ void Buddy::free (void *ptr)
     // Ensure memory is within allocator range
     assert (valid (idx));
 
+    auto const block { index_to_block (idx) };
+
+    // Ensure block was used
+    assert (block->tag == Block::Tag::USED);
+
+    if (EXPECT_TRUE (Cpu::booted()))
+        Statistics::cpu().buddy_free.inc();
+
+    // Put low-order blocks of the home node into the per-core cache and only drain it when full
+    if (EXPECT_TRUE (cached (block->ord) && block->node == Numa::node)) {
+
+        cache.enqueue (block);
+
+        if (EXPECT_FALSE (cache.count (block->ord) > Cache::limit)) {
+            Lock_guard <Spinlock> guard { zone[Numa::node].lock };
+            drain (block->ord);
+        }
+
+        return;
+    }
+
+    Lock_guard <Spinlock> guard { zone[block->node].lock };
+
     // Coalesce to-be-freed block
-    coalesce (index_to_block (idx));
+    coalesce (block);
 }
 
 /*
@@ -173,3 +359,51 @@ void Buddy::wait (void *ptr)
     // Waitlist to-be-freed block
     waitlist.enqueue (index_to_block (idx));
 }
+
+/*
+ * Abandon all deferred memory regions of this core
+ *
+ * A failed TLB invalidation leaves them reachable, so they are never freed.
+ */
+void Buddy::leak_wait()
+{
+    unsigned n { 0 };
+
+    for (; waitlist.dequeue(); n++) ;
+
+    trace (TRACE_ERROR, "BUDDY: Leaked %u deferred blocks", n);
+}
+
+/*
+ * Free all deferred memory regions of this core
+ */
+void Buddy::free_wait()
+{
+    if (EXPECT_TRUE (waitlist.empty()))
+        return;
+
+    auto const h { home() };
+
+    Waitlist remote;
+
+    {   Lock_guard <Spinlock> guard { zone[h].lock };
+
+        // Cache or coalesce home-node blocks, with one lock acquisition for the entire waitlist
+        for (Block *b; (b = waitlist.dequeue()); )
+            if (b->node != h)
+                remote.enqueue (b);
+            else if (cached (b->ord))
+                cache.enqueue (b);
+            else
+                coalesce (b);
+
+        for (order_t o { 0 }; cached (o); o++)
+            drain (o);
+    }
+
+    // Coalesce remote-node blocks, holding only one zone lock at a time
+    for (Block *b; (b = remote.dequeue()); ) {
+        Lock_guard <Spinlock> guard { zone[b->node].lock };
+        coalesce (b);
+    }
+}
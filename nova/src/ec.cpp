@@ -21,7 +21,7 @@
  */
 
 #include "abi.hpp"
-#include "counter.hpp"
+#include "statistics.hpp"
 #include "ec_arch.hpp"
 #include "elf.hpp"
 #include "extern.hpp"
@@ -37,7 +37,7 @@
 #include "stdio.hpp"
 #include "timer.hpp"
 
-INIT_PRIORITY (PRIO_SLAB) Slab_cache Ec::cache { sizeof (Ec_arch), Kobject::alignment };
+INIT_PRIORITY (PRIO_SLAB) Slab_cache Ec::cache { sizeof (Ec_arch), Kobject::alignment, true };
 
 Atomic<Ec *>    Ec::current     { nullptr };
 Ec *            Ec::fpowner     { nullptr };
@@ -100,7 +100,7 @@ void Ec::create_idle()
     Status s;
 
     auto const ec { Ec::create (Cpu::id, idle) };
-    auto const sc { Pd::create_sc (s, &Space_obj::nova, Space_obj::Selector::NOVA_CPU + Cpu::id, ec, Cpu::id, 1000, 0, 0) };
+    auto const sc { Pd::create_sc (s, &Space_obj::nova, Space_obj::Selector::NOVA_CPU + Cpu::id, ec, 1000, 0, 0) };
 
     assert (ec && sc);
 
@@ -139,7 +139,7 @@ void Ec::create_root()
     auto utcb_addr { (Space_hst::selectors() - 2) << PAGE_BITS };
 
     auto const ec { Pd::create_ec (s, obj, Space_obj::selectors - 4, Pd::root, Cpu::id, 0, 0, utcb_addr, BIT (2) | BIT (1)) };
-    auto const sc { Pd::create_sc (s, obj, Space_obj::selectors - 5, ec, Cpu::id, 1000, Scheduler::priorities - 1, 0) };
+    auto const sc { Pd::create_sc (s, obj, Space_obj::selectors - 5, ec, 1000, Scheduler::priorities - 1, 0) };
 
     if (EXPECT_FALSE (!ec || !sc))
         return;
@@ -232,7 +232,8 @@ void Ec::help (Ec *ec, cont_t c)
     if (EXPECT_FALSE (Cpu::hazard & Hazard::SCHED))
         Scheduler::schedule (false);
 
-    Counter::helping.inc();
+    Statistics::cpu().helping.inc();
+    Scheduler::get_current()->get_stats().helping.inc();
 
     ec->activate();
 
@@ -265,6 +266,113 @@ void Ec::kill (char const *reason)
     reply (dead);
 }
 
+/*
+ * Return to the CPU where a cross-CPU portal call originated
+ *
+ * The EC retries until it arrives, unless it can no longer migrate because
+ * further SCs were bound to it meanwhile. It then stays on this CPU and the
+ * call completes with BAD_CPU, even if the portal handler replied.
+ *
+ * A reply can resume the EC on the SC of a helper, which must not be
+ * retargeted. The EC then yields until it runs on its own SC again.
+ *
+ * @param resume        Continuation after the migration
+ */
+void Ec::return_home (cont_t resume)
+{
+    auto const sc { Scheduler::get_current() };
+
+    if (EXPECT_FALSE (sc->get_ec() != this)) {
+        cont = resume;
+        Scheduler::schedule();
+    }
+
+    if (home != cpu && migratable()) {
+
+        if (!hop)
+            hop = Timer::time();
+
+        cont = resume;
+        sc->migrate (home);
+        Scheduler::schedule();
+    }
+
+    regs.hazard.clr (Hazard::HOME);
+
+    if (hop) {
+        Statistics::cpu().ipc_xcpu_hop.add (Timer::time() - hop);
+        hop = 0;
+    }
+
+    if (EXPECT_FALSE (home != cpu)) {
+        trace (TRACE_ERROR, "EC:%p stranded on CPU:%u (home CPU:%u)", static_cast<void *>(this), static_cast<unsigned>(cpu), home);
+        sc->migrate (cpu);
+        Sys_abi (sys_regs()).p0() = std::to_underlying (Status::BAD_CPU);
+    }
+}
+
+/*
+ * Migrate the EC to another CPU (must run on the current CPU of the EC)
+ *
+ * Only a host EC with a single SC that is neither blocked nor calling a
+ * portal can migrate. Its FPU state and timeout are tied to this CPU and
+ * are therefore released here.
+ *
+ * @param c     Destination CPU
+ * @return      True if the EC was migrated, false otherwise
+ */
+bool Ec::migrate (cpu_t c)
+{
+    assert (cpu == Cpu::id);
+
+    if (subtype != Kobject::Subtype::EC_GLOBAL || callee || blocked())
+        return false;
+
+    Lock_guard <Spinlock> guard { lock };
+
+    if (scs != 1)
+        return false;
+
+    if (fpowner == this)
+        switch_fpu (nullptr);
+
+    clr_timeout();
+
+    regs.get_hst()->init (c);
+
+    cpu = c;
+
+    return true;
+}
+
+/*
+ * Retire an EC whose last reference is gone (runs on the CPU of the EC)
+ *
+ * An EC without references may still be current or part of a portal call chain
+ * until it replies. Otherwise nothing can reach it anymore, but remote CPUs may
+ * still hold a pointer obtained from the current EC, so the EC is reclaimed
+ * after another grace period.
+ *
+ * @param e     EC that is being retired
+ */
+void Ec::retire (Rcu_elem *e)
+{
+    auto const ec { static_cast<Ec *>(e) };
+
+    assert (ec->cpu == Cpu::id);
+
+    if (EXPECT_FALSE (ec == current || ec->caller || ec->callee))
+        return ec->defer (retire);
+
+    // Discard the FPU state of the EC
+    if (fpowner == ec)
+        fpowner = nullptr;
+
+    ec->clr_timeout();
+
+    ec->defer (reclaim<Ec>);
+}
+
 /*
  * Switch FPU ownership
  *
@@ -21,6 +21,7 @@
  */
 
 #include "acpi.hpp"
+#include "buddy.hpp"
 #include "console_mbuf.hpp"
 #include "event.hpp"
 #include "hip.hpp"
@@ -31,6 +32,7 @@
 #include "space_gst.hpp"
 #include "space_hst.hpp"
 #include "space_obj.hpp"
+#include "statistics.hpp"
 #include "stc.hpp"
 #include "stdio.hpp"
 #include "uefi.hpp"
@@ -41,6 +43,10 @@ Hip *Hip::hip { reinterpret_cast<Hip *>(&MHIP_HVAS) };
 
 void Hip::build (uint64_t root_s, uint64_t root_e)
 {
+    // The layout is ABI: extensions only ever get appended
+    static_assert (__builtin_offsetof (Hip, arch) == 0x80 && __builtin_offsetof (Hip, numa_num) == 0xa0 && __builtin_offsetof (Hip, stat_p_addr) == 0xe8 + cpus);
+    static_assert (sizeof (Hip) <= PAGE_SIZE (0));
+
     auto const uefi { &Uefi::info };
 
     signature       = Signature::u32 ("NOVA");
@@ -73,6 +79,19 @@ void Hip::build (uint64_t root_s, uint64_t root_e)
     mco_pio         = 16;
     mco_msr         = 16;
     kimax           = static_cast<uint16_t>(Memattr::kimax);
+    numa_num        = static_cast<uint16_t>(Numa::count);
+
+    // Free kernel memory per node at the time of HIP creation
+    for (unsigned n { 0 }; n < Numa::count; n++)
+        numa_mem[n] = Buddy::available (n);
+
+    for (cpu_t c { 0 }; c < Cpu::count; c++) {
+        numa_cpu[c]    = *Kmem::loc_to_glob (c, &Numa::node);
+        stat_p_addr[c] = Kmem::ptr_to_phys (Statistics::get (c));
+
+        // Per-CPU statistics are read-only for the root PD
+        Space_hst::access_ctrl (stat_p_addr[c], PAGE_SIZE (0), Paging::Permissions (Paging::U | Paging::R));
+    }
 
     trace (TRACE_ROOT, "INFO: NOVA: %#018lx-%#018lx", nova_p_addr, nova_e_addr);
     trace (TRACE_ROOT, "INFO: MBUF: %#018lx-%#018lx", mbuf_p_addr, mbuf_e_addr);
@@ -86,6 +105,10 @@ void Hip::build (uint64_t root_s, uint64_t root_e)
     trace (TRACE_ROOT, "INFO: CPU#: %3u", cpu_num);
     trace (TRACE_ROOT, "INFO: INT#: %3u + %u", int_pin, int_msi);
     trace (TRACE_ROOT, "INFO: KEY#: %3u", kimax);
+    trace (TRACE_ROOT, "INFO: NUM#: %3u", numa_num);
+
+    for (unsigned n { 0 }; n < numa_num; n++)
+        trace (TRACE_ROOT, "INFO: NODE: %u %lu KiB", n, numa_mem[n] >> 10);
 
     arch.build();
 
@@ -15,8 +15,10 @@
  * GNU General Public License version 2 for more details.
  */
 
+#include "ec.hpp"
 #include "integrity.hpp"
 #include "ptab_hpt.hpp"
+#include "sha_arch.hpp"
 
 bool Integrity::measure()
 {
@@ -27,6 +29,10 @@ bool Integrity::measure()
     Hash_sha2_384 sha2_384;
     Hash_sha2_512 sha2_512;
 
+    // SIMD block functions need the FPU, so take it away from any owner for the duration
+    if (Sha_arch::init())
+        Ec::switch_fpu (nullptr);
+
     // Even for size 0 the loop must execute once to yield a valid digest
     for (uint64_t p { root_phys }, s { root_size };; p += chunk_size) {
 
@@ -36,8 +42,7 @@ bool Integrity::measure()
 
         sha1_160.update (ptr, len, s);
         sha2_256.update (ptr, len, s);
-        sha2_384.update (ptr, len, s);
-        sha2_512.update (ptr, len, s);
+        sha2_384.update (sha2_512, ptr, len, s);
 
         if (!s)
             break;
@@ -0,0 +1,104 @@
+/*
+ * Non-Uniform Memory Access (NUMA) Topology
+ *
+ * Copyright (C) 2019-2024 Udo Steinberg, BedRock Systems, Inc.
+ *
+ * This file is part of the NOVA microhypervisor.
+ *
+ * NOVA is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * NOVA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ */
+
+#include "numa.hpp"
+
+uint8_t Numa::node;
+
+/*
+ * Map a proximity domain to a node, allocating a new node if necessary
+ *
+ * Proximity domains beyond the supported number of nodes are folded into node 0
+ *
+ * @param d     Proximity domain
+ * @return      Node
+ */
+unsigned Numa::node_by_domain (uint32_t d)
+{
+    for (unsigned n { 0 }; n < num_dom; n++)
+        if (domain[n] == d)
+            return n;
+
+    if (EXPECT_FALSE (num_dom == nodes))
+        return 0;
+
+    domain[num_dom] = d;
+
+    return (count = ++num_dom) - 1;
+}
+
+/*
+ * Record the node of a physical memory range
+ *
+ * @param b     Base address
+ * @param s     Size
+ * @param d     Proximity domain
+ */
+void Numa::add_memory (uint64_t b, uint64_t s, uint32_t d)
+{
+    auto const n { node_by_domain (d) };
+
+    if (EXPECT_FALSE (num_mem == sizeof (memory) / sizeof (*memory)))
+        return;
+
+    memory[num_mem++] = { .base = b, .size = s, .node = static_cast<uint8_t>(n) };
+}
+
+/*
+ * Record the node of a processor
+ *
+ * @param i     Processor ID (APIC ID)
+ * @param d     Proximity domain
+ */
+void Numa::add_processor (uint32_t i, uint32_t d)
+{
+    auto const n { node_by_domain (d) };
+
+    if (EXPECT_FALSE (num_prc == sizeof (processor) / sizeof (*processor)))
+        return;
+
+    processor[num_prc++] = { .id = i, .node = static_cast<uint8_t>(n) };
+}
+
+/*
+ * Determine the node of a physical address
+ *
+ * @param p     Physical address
+ * @return      Node (or 0 if the address has no recorded affinity)
+ */
+unsigned Numa::node_by_phys (uint64_t p)
+{
+    for (unsigned i { 0 }; i < num_mem; i++)
+        if (p - memory[i].base < memory[i].size)
+            return memory[i].node;
+
+    return 0;
+}
+
+/*
+ * Determine the node of this CPU
+ *
+ * @param i     Processor ID (APIC ID)
+ */
+void Numa::init (uint32_t i)
+{
+    node = 0;
+
+    for (unsigned p { 0 }; p < num_prc; p++)
+        if (processor[p].id == i)
+            node = processor[p].node;
+}
@@ -32,7 +32,7 @@
 #include "space_pio.hpp"
 #include "stdio.hpp"
 
-INIT_PRIORITY (PRIO_SLAB) Slab_cache Pd::cache { sizeof (Pd), Kobject::alignment };
+INIT_PRIORITY (PRIO_SLAB) Slab_cache Pd::cache { sizeof (Pd), Kobject::alignment, true };
 
 Pd::Pd() : Kobject { Kobject::Type::PD },
            dma_cache { sizeof (Space_dma), Kobject::alignment },
@@ -190,9 +190,9 @@ Ec *Pd::create_ec (Status &s, Space_obj *obj, unsigned long sel, Pd *pd, cpu_t c
     return nullptr;
 }
 
-Sc *Pd::create_sc (Status &s, Space_obj *obj, unsigned long sel, Ec *ec, cpu_t cpu, uint16_t budget, uint8_t prio, cos_t cos)
+Sc *Pd::create_sc (Status &s, Space_obj *obj, unsigned long sel, Ec *ec, uint16_t budget, uint8_t prio, cos_t cos)
 {
-    auto const o { Sc::create (s, ec, cpu, budget, prio, cos) };
+    auto const o { Sc::create (s, ec, budget, prio, cos) };
 
     if (EXPECT_TRUE (o)) {
 
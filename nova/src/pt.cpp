@@ -23,7 +23,7 @@
 #include "pt.hpp"
 #include "stdio.hpp"
 
-INIT_PRIORITY (PRIO_SLAB) Slab_cache Pt::cache { sizeof (Pt), Kobject::alignment };
+INIT_PRIORITY (PRIO_SLAB) Slab_cache Pt::cache { sizeof (Pt), Kobject::alignment, true };
 
 Pt::Pt (Refptr<Ec> &e, uintptr_t i) : Kobject { Kobject::Type::PT }, ec { std::move (e) }, ip { i }
 {
@@ -229,14 +229,155 @@ template<typename T, typename I, typename O> Status Ptab<T,I,O>::update (IAddr v
     return Status::SUCCESS;
 }
 
+/*
+ * Collapse page tables into large pages
+ *
+ * A page table is replaced with a single leaf PTE at the next level if all its PTEs
+ * are leaves that map physically contiguous memory with identical attributes and
+ * the resulting large page is properly aligned.
+ *
+ * The caller must serialize promotion against all other updates of the page table,
+ * because an update may still hold a pointer into a page table that gets replaced.
+ * Replaced page tables wait for Buddy::free_wait, so the caller must invalidate the
+ * TLB before releasing them.
+ *
+ * @param v     Virtual address of a range that update() has just mapped
+ * @param ord   Order of the range
+ */
+template<typename T, typename I, typename O> void Ptab<T,I,O>::promote (IAddr v, unsigned ord)
+{
+    auto l { min (ord / T::bpl, mll) };
+
+    if (l == mll)
+        return;
+
+    // Only a page table whose first or last slot has been filled can have become fully populated
+    auto const n { BIT (ord - l * T::bpl) };
+
+    if (T::lev_idx (l, v) != 0 && T::lev_idx (l, v) + n != T::lev_ent (l))
+        return;
+
+    // Try successively larger pages up to the maximum leaf level
+    for (; l < mll; l++) {
+
+        // Get pointer to the PTE that refers to the page table
+        auto const ptr { walk (v, l + 1, false) };
+
+        // Skippable hole
+        if (ptr == reinterpret_cast<decltype (ptr)>(~0UL))
+            return;
+
+        // Atomically read the PTE from the slot
+        auto old { static_cast<T>(*ptr) };
+
+        if (old.type (l + 1) != Entry::Type::PTAB)
+            return;
+
+        auto const ptab { old.operator->() };
+        auto const base { static_cast<T>(ptab->entry) };
+        auto const size { T::page_size (l * T::bpl) };
+
+        // The first PTE must be a leaf that is aligned for the large page
+        if (base.type (l) != Entry::Type::LEAF || base.addr (l) & T::offs_mask ((l + 1) * T::bpl))
+            return;
+
+        // All other PTEs must continue the first one
+        for (unsigned i { 1 }; i < T::lev_ent (l); i++)
+            if (!(static_cast<T>(ptab[i].entry) == T (base.val + i * size)))
+                return;
+
+        // Construct a new PTE that refers to the large page
+        T pte { base.addr (l) | T::page_attr (l + 1, base.page_pm(), base.page_ma (l)) };
+
+        // Try to replace the page table with the large page; someone else may have changed it
+        if (!ptr->compare_exchange (old, pte))
+            return;
+
+        // Ensure PTE observability
+        T::noncoherent ? Cache::data_clean (ptr) : T::publish();
+
+        // Other CPUs may still walk the page table until the TLB invalidation has completed
+        operator delete (ptab, true);
+    }
+}
+
+/*
+ * Deallocate all page tables
+ *
+ * The caller must ensure that the page tables are no longer in use by any CPU or device.
+ *
+ * @param k     True if kernel memory that is still mapped by leaf PTEs should be freed as well
+ */
+template<typename T, typename I, typename O> void Ptab<T,I,O>::destroy (bool k)
+{
+    auto const l { T::lev() };
+
+    // Atomically read the root PTE
+    auto const old { static_cast<T>(entry) };
+
+    // If the root PTE refers to a page table, then deallocate it
+    if (old.type (l) == Entry::Type::PTAB)
+        old->deallocate (l - 1, k);
+
+    entry = Entry (0);
+}
+
+/*
+ * Deallocate a page table that shares subtrees with other page tables
+ *
+ * Only the root table and the tables directly below it are private. PTEs below
+ * the root that are identical to those of the specified page table and all PTEs
+ * of the private tables below the root refer to shared page tables.
+ *
+ * @param s     Page table with which the root PTEs are shared
+ */
+template<typename T, typename I, typename O> void Ptab<T,I,O>::destroy (Ptab const &s)
+{
+    auto const l { T::lev() };
+
+    // Atomically read the root PTEs
+    auto const old { static_cast<T>(entry) };
+    auto const shr { static_cast<T>(s.entry) };
+
+    // If the root PTE refers to a page table, then deallocate it
+    if (old.type (l) == Entry::Type::PTAB)
+        old->deallocate_root (l - 1, shr.type (l) == Entry::Type::PTAB ? shr.operator->() : nullptr);
+
+    entry = Entry (0);
+}
+
+/*
+ * Deallocate a root table and its private page tables
+ *
+ * @param l     Root level
+ * @param s     Root table with which PTEs are shared (or nullptr)
+ */
+template<typename T, typename I, typename O> void Ptab<T,I,O>::deallocate_root (unsigned l, Ptab const *s)
+{
+    // Iterate over all slots
+    for (unsigned i { 0 }; i < T::lev_ent (l); i++) {
+
+        // Atomically read the old PTE from the slot
+        auto const old { static_cast<T>(this[i].entry) };
+
+        // If the old PTE refers to a private page table, then deallocate it without its shared subtrees
+        if (old.type (l) == Entry::Type::PTAB && !(s && old == static_cast<T>(s[i].entry)))
+            operator delete (old.operator->(), Cpu::online);
+    }
+
+    // Waitlist pages after bootstrap when SMP/CPULOCAL is active
+    operator delete (this, Cpu::online);
+}
+
 /*
  * Deallocate a page table subtree
  *
  * @param l     Subtree level
+ * @param k     True if kernel memory that is still mapped by leaf PTEs should be freed as well
  */
-template<typename T, typename I, typename O> void Ptab<T,I,O>::deallocate (unsigned l)
+template<typename T, typename I, typename O> void Ptab<T,I,O>::deallocate (unsigned l, bool k)
 {
-    if (l) {
+    if (l || k) {
 
         // Iterate over all slots
         for (unsigned i { 0 }; i < T::lev_ent (l); i++) {
@@ -246,7 +387,11 @@ template<typename T, typename I, typename O> void Ptab<T,I,O>::deallocate (unsig
 
             // If the old PTE refers to a page table, then deallocate it
             if (old.type (l) == Entry::Type::PTAB)
-                old->deallocate (l - 1);
+                old->deallocate (l - 1, k);
+
+            // If the old PTE refers to kernel memory, then free it
+            else if (k && old.type (l) == Entry::Type::LEAF && old.page_pm() & Paging::K)
+                Buddy::free (Kmem::phys_to_ptr (old.addr (l)));
         }
     }
 
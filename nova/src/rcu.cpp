@@ -24,13 +24,17 @@
 #include "cpu.hpp"
 #include "hazard.hpp"
 #include "initprio.hpp"
+#include "kmem.hpp"
 #include "rcu.hpp"
+#include "statistics.hpp"
 #include "stdio.hpp"
 
 INIT_PRIORITY (PRIO_LOCAL) Rcu::List Rcu::next;
 INIT_PRIORITY (PRIO_LOCAL) Rcu::List Rcu::curr;
 INIT_PRIORITY (PRIO_LOCAL) Rcu::List Rcu::done;
 
+Atomic<Rcu_elem *> Rcu::remote { nullptr };
+
 Rcu::Epoch Rcu::epoch_l { 0 };
 Rcu::Epoch Rcu::epoch_c { 0 };
 
@@ -87,6 +91,23 @@ void Rcu::quiet()
         set_state (State::COMPLETED);
 }
 
+/*
+ * Submit a callback that must run on the specified CPU
+ *
+ * @param cpu   CPU that invokes the callback
+ * @param e     Callback element
+ */
+void Rcu::submit (cpu_t cpu, Rcu_elem *e)
+{
+    if (cpu == Cpu::id)
+        return submit (e);
+
+    auto &r { *Kmem::loc_to_glob (cpu, &remote) };
+
+    // Push onto the remote stack, which its owner drains in check()
+    for (e->next = r; !r.compare_exchange (e->next, e); ) ;
+}
+
 /*
  * Check RCU state and manage callback lifecycle
  */
@@ -94,10 +115,24 @@ void Rcu::check()
 {
     Epoch e { epoch }, g { e >> 2 };
 
+    // Adopt callbacks submitted by other CPUs
+    if (EXPECT_FALSE (remote)) {
+
+        Rcu_elem *r, *z { nullptr };
+
+        remote.exchange (r, z);
+
+        for (Rcu_elem *n; r; r = n) {
+            n = r->next;
+            next.enqueue (r);
+        }
+    }
+
     // Check if a new epoch started
     if (epoch_l != g) {
         epoch_l = g;
         Cpu::hazard |= Hazard::RCU;
+        Statistics::cpu().rcu_epoch.inc();
     }
 
     // Check if the current callbacks have completed
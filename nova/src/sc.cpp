@@ -21,12 +21,69 @@
  */
 
 #include "ec.hpp"
+#include "scheduler.hpp"
 #include "stc.hpp"
 #include "stdio.hpp"
 
-INIT_PRIORITY (PRIO_SLAB) Slab_cache Sc::cache { sizeof (Sc), Kobject::alignment };
+INIT_PRIORITY (PRIO_SLAB) Slab_cache Sc::cache { sizeof (Sc), Kobject::alignment, true };
 
-Sc::Sc (Refptr<Ec> &e, cpu_t n, uint16_t b, uint8_t p, cos_t c) : Kobject { Kobject::Type::SC }, ec { std::move (e) }, budget { Stc::ms_to_ticks (b) }, cpu { n }, cos { c }, prio { p }
+Sc::Sc (Refptr<Ec> &e, uint16_t b, uint8_t p, cos_t c) : Kobject { Kobject::Type::SC }, ec { std::move (e) }, budget { Stc::ms_to_ticks (b) }, cpu { ec->bind_sc() }, dst { cpu }, cos { c }, prio { p }
 {
     trace (TRACE_CREATE, "SC:%p created (EC:%p CPU:%u Budget:%ums Prio:%u COS:%u)", static_cast<void *>(this), static_cast<void *>(ec), cpu, b, p, c);
 }
+
+/*
+ * Apply the replenishment policy when the CPU dispatches the SC
+ *
+ * @param t     Current time
+ * @return      Time slice the SC may run
+ */
+uint64_t Sc::server (uint64_t t)
+{
+    if (EXPECT_FALSE (per != period)) {
+        refill.dequeue();
+        armed = false;
+        cap = budget;
+        next = t;
+        per = period;
+    }
+
+    if (!per)
+        return left;
+
+    if (!armed) {
+
+        if (sporadic)
+            next = t + per;
+        else if (next <= t)
+            next += ((t - next) / per + 1) * per;
+
+        refill.enqueue (next);
+        armed = true;
+    }
+
+    return cap < left ? cap : left;
+}
+
+/*
+ * Restore the capacity and resume the SC if it was parked
+ */
+void Sc::replenish()
+{
+    cap = budget;
+    armed = false;
+
+    if (parked) {
+        parked = false;
+        Scheduler::unblock (this);
+    }
+}
+
+void Sc::destroy()
+{
+    ec->unbind_sc();
+
+    this->~Sc();
+
+    operator delete (this, cache);
+}
@@ -21,29 +21,57 @@
  */
 
 #include "assert.hpp"
+#include "cmdline.hpp"
 #include "cos.hpp"
-#include "counter.hpp"
 #include "cpu.hpp"
 #include "ec.hpp"
 #include "interrupt.hpp"
+#include "statistics.hpp"
+#include "stc.hpp"
 #include "timeout_budget.hpp"
 #include "timer.hpp"
 
 INIT_PRIORITY (PRIO_LOCAL)  Scheduler::Ready    Scheduler::ready;
 INIT_PRIORITY (PRIO_LOCAL)  Scheduler::Release  Scheduler::release;
+INIT_PRIORITY (PRIO_LOCAL)  Scheduler::Load     Scheduler::load;
 
 Sc *Scheduler::current { nullptr };
+uint16_t Scheduler::waiting[32];
+uint32_t Scheduler::waitmap;
+bool Scheduler::tickless;
 
 void Scheduler::Ready::enqueue (Sc *sc, uint64_t t)
 {
     assert (sc->cpu == Cpu::id);
     assert (sc->prio < priorities);
 
-    if (sc->prio > prio_top)
-        prio_top = sc->prio;
+    // The SC no longer bounds the wakeup latency of idle states
+    if (EXPECT_FALSE (sc->waitlat)) {
+        auto const b { bit_scan_reverse (sc->waitlat) };
+        if (!--waiting[b])
+            waitmap &= ~BIT (b);
+        sc->waitlat = 0;
+    }
+
+    // Park a depleted server SC until its replenishment
+    if (EXPECT_FALSE (sc->per && !sc->cap)) {
+        sc->parked = true;
+        return;
+    }
+
+    // A competitor ends tickless operation of the current SC
+    if (EXPECT_FALSE (tickless) && sc != current && sc->prio == current->prio) {
+        Timeout_budget::timeout.dequeue();
+        Timeout_budget::timeout.enqueue (t + settle (t));
+    }
+
+    set (sc->prio);
 
     queue[sc->prio].enqueue (sc, sc->left);
 
+    if (sc->prio)
+        load.ready = load.ready + 1;
+
     if (sc->prio > current->prio || (sc != current && sc->prio == current->prio && sc->left))
         Cpu::hazard |= Hazard::SCHED;
 
@@ -55,14 +83,21 @@ void Scheduler::Ready::enqueue (Sc *sc, uint64_t t)
 
 auto Scheduler::Ready::dequeue (uint64_t t)
 {
-    auto const sc { queue[prio_top].dequeue_head() };
+    auto const top { prio_top() };
+    auto const sc { queue[top].dequeue_head() };
 
     assert (sc);
     assert (sc->cpu == Cpu::id);
     assert (sc->prio < priorities);
 
-    while (queue[prio_top].empty() && prio_top)
-        prio_top--;
+    // Account for the empty queues that a linear scan would have visited
+    if (queue[top].empty()) {
+        clr (top);
+        Statistics::cpu().sched_scan.add (top - prio_top());
+    }
+
+    if (sc->prio)
+        load.ready = load.ready - 1;
 
     if (EXPECT_TRUE (sc->ec != current->ec))
         sc->ec->adjust_offset_ticks (t - sc->last);
@@ -72,32 +107,96 @@ auto Scheduler::Ready::dequeue (uint64_t t)
     return sc;
 }
 
-void Scheduler::Release::enqueue (Sc *sc)
+/*
+ * Migrate a ready SC of equal or lower priority than the next SC to another CPU
+ *
+ * @param c     Destination CPU
+ * @return      True if an SC was migrated, false otherwise
+ */
+bool Scheduler::Ready::offload (cpu_t c)
 {
-    auto const r { Kmem::loc_to_glob (sc->cpu, this) };
+    auto const top { prio_top() };
+
+    for (auto p { top }; p; p--) {
+
+        auto const sc { queue[p].last() };
+
+        // Keep the SC that runs next
+        if (!sc || sc == queue[top].first())
+            continue;
+
+        queue[p].dequeue (sc);
+
+        if (queue[p].empty())
+            clr (p);
 
-    bool notify;
+        if (migrate (sc, c)) {
+            load.ready = load.ready - 1;
+            return true;
+        }
 
-    {   Lock_guard <Spinlock> guard { r->lock };
+        set (p);
 
-        notify = r->queue.enqueue_tail (sc);
+        queue[p].enqueue_tail (sc);
+
+        break;
     }
 
-    if (notify)
+    return false;
+}
+
+/*
+ * Release an SC to the release queue of its CPU (any CPU)
+ *
+ * Only the first producer after a drain sends the RRQ IPI.
+ *
+ * @param sc    SC that is not queued anywhere
+ */
+void Scheduler::Release::enqueue (Sc *sc)
+{
+    auto const r { Kmem::loc_to_glob (sc->cpu, this) };
+
+    for (sc->rel = r->head; !r->head.compare_exchange (sc->rel, sc); ) ;
+
+    bool o, n { true };
+    r->kick.exchange (o, n);
+
+    if (!o)
         Interrupt::send_cpu (Interrupt::Request::RRQ, sc->cpu);
 }
 
-auto Scheduler::Release::dequeue()
+/*
+ * Drain the release queue of the current CPU
+ *
+ * The kick flag is cleared before the drain, so that an SC released after the
+ * drain triggers another IPI.
+ *
+ * @return      Released SCs in FIFO order, linked via Sc::rel
+ */
+Sc *Scheduler::Release::dequeue()
 {
-    Lock_guard <Spinlock> guard { lock };
+    kick.store (false, __ATOMIC_SEQ_CST);
+
+    Sc *l { nullptr }, *f { nullptr };
+    head.exchange (l, f);
+
+    // Reverse the list
+    for (Sc *n; l; f = l, l = n) {
+        n = l->rel;
+        l->rel = f;
+    }
 
-    return queue.dequeue_head();
+    return f;
 }
 
 void Scheduler::unblock (Sc *sc)
 {
+    auto const t { Timer::time() };
+
+    sc->woken = t;
+
     if (Cpu::id == sc->cpu)
-        ready.enqueue (sc, Timer::time());
+        ready.enqueue (sc, t);
     else
         release.enqueue (sc);
 }
@@ -106,35 +205,155 @@ void Scheduler::requeue()
 {
     auto const t { Timer::time() };
 
-    for (Sc *sc; (sc = release.dequeue()); ready.enqueue (sc, t)) ;
+    for (Sc *sc { release.dequeue() }, *n; sc; sc = n) {
+        n = sc->rel;
+        sc->rel = nullptr;
+        ready.enqueue (sc, t);
+    }
+}
+
+/*
+ * Migrate a dequeued SC to another CPU via its release queue
+ *
+ * @param sc    SC that is not queued anywhere (on its current CPU)
+ * @param c     Destination CPU
+ * @return      True if the SC was migrated, false otherwise
+ */
+bool Scheduler::migrate (Sc *sc, cpu_t c)
+{
+    assert (sc->cpu == Cpu::id);
+    assert (!sc->queued());
+
+    if (c == sc->cpu || c >= Cpu::count || !sc->ec->migrate (c))
+        return false;
+
+    trace (TRACE_SCHEDULE, "SC:%p migrated (CPU:%u->%u)", static_cast<void *>(sc), sc->cpu, c);
+
+    sc->refill.dequeue();
+    sc->armed = false;
+
+    sc->cpu = sc->dst = c;
+
+    release.enqueue (sc);
+
+    return true;
+}
+
+/*
+ * Hand a waiting SC to an idle CPU (optional work stealing)
+ */
+void Scheduler::balance()
+{
+    if (EXPECT_TRUE (!Cmdline::steal || !idlers || load.ready < 2))
+        return;
+
+    for (cpu_t c { 0 }; c < Cpu::count; c++)
+        if (c != Cpu::id && get_load (c)->idle) {
+            ready.offload (c);
+            return;
+        }
+}
+
+/*
+ * Settle the budget of the current SC, which ran without a budget timeout
+ *
+ * While it ran alone, its budget was refilled whenever it ran out, as if
+ * the budget timeout had expired and no other SC had been ready.
+ *
+ * @param t     Current time
+ * @return      Remaining budget
+ */
+uint64_t Scheduler::settle (uint64_t t)
+{
+    tickless = false;
+
+    auto const e { t - current->last };
+
+    if (e < current->left)
+        return current->left - e;
+
+    // The refills were never observed as budget exhaustions, so they are not counted as such
+    return current->budget - (e - current->left) % current->budget;
 }
 
 void Scheduler::schedule (bool blocked)
 {
-    Counter::schedule.inc();
+    Statistics::cpu().schedule.inc();
 
     assert (current);
     assert (blocked || !current->queued());
 
     auto const t { Timer::time() };
     auto const d { Timeout_budget::timeout.dequeue() };
+    auto const r { tickless && d <= t };    // Residual tick
+
+    current->stats.used.add (t - current->last);
+    current->left = tickless ? settle (t) : d > t ? d - t : 0;
 
-    current->used = current->used + (t - current->last);
-    current->left = d > t ? d - t : 0;
+    if (current->per)
+        current->cap -= min (current->cap, t - current->last);
 
     Cpu::hazard &= ~Hazard::SCHED;
 
-    if (EXPECT_TRUE (!blocked))
+    if (EXPECT_FALSE (!current->prio))
+        Statistics::cpu().idle.add (t - current->last);
+
+    if (EXPECT_TRUE (!blocked)) {
+        if (EXPECT_TRUE (!r))
+            (current->left ? current->stats.preempt : current->stats.deplete).inc();
         ready.enqueue (current, t);
+    } else if (!current->queued() && (current->waitlat = current->latency)) {
+        auto const b { bit_scan_reverse (current->waitlat) };
+        waiting[b]++;
+        waitmap |= BIT (b);
+    }
+
+    balance();
 
     for (;;) {
 
         current = ready.dequeue (t);
 
+        // Reclaim an SC whose last reference is gone
+        if (EXPECT_FALSE (current->dead)) {
+            current->refill.dequeue();
+            current->defer (Kobject::reclaim<Sc>);
+            continue;
+        }
+
+        // Honor a pending migration request
+        if (EXPECT_FALSE (current->dst != current->cpu) && migrate (current, current->dst))
+            continue;
+
+        // Advertise idle CPUs for work stealing
+        if (EXPECT_FALSE (load.idle != !current->prio)) {
+            if ((load.idle = !current->prio))
+                idlers++;
+            else
+                idlers--;
+        }
+
+        current->stats.dispatch.inc();
+
+        // Wakeup latency, which the TSCs of the unblocking and this CPU may skew
+        if (current->woken) {
+            auto const us { Stc::ticks_to_us (t > current->woken ? t - current->woken : 0) };
+            current->stats.wakeup[min (max (bit_scan_reverse (us), 0) / 2, 7)].inc();
+            current->woken = 0;
+        }
+
         Cos::make_current (current->cos);
 
-        Timeout_budget::timeout.enqueue (t + current->left);
+        auto const s { current->server (t) };
+
+        // Skip the budget timeout if no other SC could be chosen at its expiry,
+        // but keep a residual tick, which drives RCU
+        auto const l { Stc::ms_to_ticks (residual_ms) };
+        tickless = !current->per && s < l && ready.empty (current->prio);
+
+        Timeout_budget::timeout.enqueue (t + (tickless ? l : s));
         current->ec->activate();
         Timeout_budget::timeout.dequeue();
+        tickless = false;
     }
 }
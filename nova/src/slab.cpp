@@ -22,8 +22,10 @@
 #include "assert.hpp"
 #include "bits.hpp"
 #include "buddy.hpp"
+#include "cpu.hpp"
 #include "lock_guard.hpp"
 #include "slab.hpp"
+#include "statistics.hpp"
 #include "std.hpp"
 
 struct Slab_cache::Slab
@@ -131,11 +133,116 @@ struct Slab_cache::Slab
     }
 };
 
+struct Slab_cache::Magazine
+{
+    static constexpr unsigned capacity { 14 };
+
+    static Slab_cache cache;                        // Magazine Slab Cache
+
+    Magazine *  next    { nullptr };                // Depot Magazine Linkage
+    unsigned    count   { 0 };                      // Number of Buffers
+    void *      data[capacity];                     // Buffers
+
+    bool full() const   { return count == capacity; }
+    bool empty() const  { return count == 0; }
+
+    ALWAYS_INLINE
+    void push (void *p) { data[count++] = p; }
+
+    ALWAYS_INLINE
+    void *pop() { return data[--count]; }
+
+    [[nodiscard]] static void *operator new (size_t) noexcept
+    {
+        return cache.alloc();
+    }
+
+    static void operator delete (void *ptr)
+    {
+        cache.free (ptr);
+    }
+};
+
+INIT_PRIORITY (PRIO_SLAB) Slab_cache Slab_cache::Magazine::cache { sizeof (Slab_cache::Magazine), alignof (Slab_cache::Magazine) };
+
+Slab_cache::Local Slab_cache::local[Slab_cache::slots];
+Slab_cache::Depot Slab_cache::depot[Slab_cache::slots];
+
+/*
+ * Take a full magazine from the depot
+ *
+ * @return  Pointer to the magazine or nullptr if the depot has none
+ */
+Slab_cache::Magazine *Slab_cache::Depot::get_full()
+{
+    Lock_guard <Spinlock> guard { lock };
+
+    auto const m { full };
+
+    if (m) {
+        full = m->next;
+        count--;
+    }
+
+    return m;
+}
+
+/*
+ * Take an empty magazine from the depot
+ *
+ * @return  Pointer to the magazine or nullptr if the depot has none
+ */
+Slab_cache::Magazine *Slab_cache::Depot::get_empty()
+{
+    Lock_guard <Spinlock> guard { lock };
+
+    auto const m { empty };
+
+    if (m)
+        empty = m->next;
+
+    return m;
+}
+
+/*
+ * Return a full magazine to the depot
+ *
+ * @param m Pointer to the magazine
+ * @return  true if the depot accepted the magazine, false if the depot is at its limit
+ */
+bool Slab_cache::Depot::put_full (Magazine *m)
+{
+    Lock_guard <Spinlock> guard { lock };
+
+    if (EXPECT_FALSE (count == limit))
+        return false;
+
+    m->next = full;
+    full = m;
+    count++;
+
+    return true;
+}
+
+/*
+ * Return an empty magazine to the depot
+ *
+ * @param m Pointer to the magazine
+ */
+void Slab_cache::Depot::put_empty (Magazine *m)
+{
+    Lock_guard <Spinlock> guard { lock };
+
+    m->next = empty;
+    empty = m;
+}
+
 /*
  * Slab Cache Constructor
  *
  * @param s Required element size
  * @param a Required element alignment (must be a power of 2)
+ * @param m Use per-core magazines in front of the slabs
  *
  * Slab Linkage Example (P:partial precede F:full)
  *
@@ -148,18 +255,27 @@ struct Slab_cache::Slab
  * !head && !curr => slab cache contains no slabs => initial state
  * !head &&  curr => illegal
  */
-Slab_cache::Slab_cache (size_t s, size_t a) : bsz (static_cast<uint16_t>(align_up (max (s, sizeof (Slab::Buffer)), max (a, alignof (Slab::Buffer))))),
-                                              bps ((PAGE_SIZE (0) - sizeof (Slab::Metadata)) / bsz) {}
+Slab_cache::Slab_cache (size_t s, size_t a, bool m) : bsz (static_cast<uint16_t>(align_up (max (s, sizeof (Slab::Buffer)), max (a, alignof (Slab::Buffer))))),
+                                                      bps ((PAGE_SIZE (0) - sizeof (Slab::Metadata)) / bsz),
+                                                      slot (m && slots_used < slots ? static_cast<uint8_t>(++slots_used) : 0) {}
 
 /*
- * Allocate an element in this slab cache
+ * Determine if this slab cache uses its per-core magazines
  *
- * @return  Pointer to the element (success) or nullptr (failure)
+ * @return  true if magazines are used, false otherwise
  */
-void *Slab_cache::alloc()
+bool Slab_cache::magazines() const
 {
-    Lock_guard <Spinlock> guard { lock };
+    return slot && Cpu::booted();
+}
 
+/*
+ * Allocate an element from the slabs (slab cache lock must be held)
+ *
+ * @return  Pointer to the element (success) or nullptr (failure)
+ */
+void *Slab_cache::get()
+{
     // Cache contains no slabs or only full slabs
     if (EXPECT_FALSE (!curr)) {
 
@@ -196,14 +312,12 @@ void *Slab_cache::alloc()
 }
 
 /*
- * Free an element in this slab cache
+ * Free an element to the slabs (slab cache lock must be held)
  *
  * @param p Pointer to the element
  */
-void Slab_cache::free (void *p)
+void Slab_cache::put (void *p)
 {
-    Lock_guard <Spinlock> guard { lock };
-
     // Compute slab for this element
     auto const slab { Slab::from_buffer (p) };
 
@@ -258,3 +372,103 @@ void Slab_cache::free (void *p)
         curr = slab;
     }
 }
+
+/*
+ * Return all elements of a magazine to the slabs
+ *
+ * @param m Pointer to the magazine
+ */
+void Slab_cache::flush (Magazine *m)
+{
+    Lock_guard <Spinlock> guard { lock };
+
+    while (!m->empty())
+        put (m->pop());
+}
+
+/*
+ * Allocate an element in this slab cache
+ *
+ * @return  Pointer to the element (success) or nullptr (failure)
+ */
+void *Slab_cache::alloc()
+{
+    if (EXPECT_TRUE (Cpu::booted()))
+        Statistics::cpu().slab_alloc.inc();
+
+    if (EXPECT_TRUE (magazines())) {
+
+        auto &l { local[slot - 1] };
+
+        // Allocate from the loaded magazine
+        if (EXPECT_TRUE (l.loaded && !l.loaded->empty()))
+            return l.loaded->pop();
+
+        // Allocate from the previous magazine, which is full
+        if (l.previous && !l.previous->empty()) {
+            std::swap (l.loaded, l.previous);
+            return l.loaded->pop();
+        }
+
+        // Exchange the empty previous magazine for a full one from the depot
+        if (auto const m { depot[slot - 1].get_full() }; m) {
+
+            if (l.previous)
+                depot[slot - 1].put_empty (l.previous);
+
+            l.previous = l.loaded;
+            l.loaded   = m;
+
+            return l.loaded->pop();
+        }
+    }
+
+    Lock_guard <Spinlock> guard { lock };
+
+    return get();
+}
+
+/*
+ * Free an element in this slab cache
+ *
+ * @param p Pointer to the element
+ */
+void Slab_cache::free (void *p)
+{
+    if (EXPECT_TRUE (Cpu::booted()))
+        Statistics::cpu().slab_free.inc();
+
+    if (EXPECT_TRUE (magazines())) {
+
+        auto &l { local[slot - 1] };
+
+        // Free into the loaded magazine
+        if (EXPECT_TRUE (l.loaded && !l.loaded->full()))
+            return l.loaded->push (p);
+
+        // Free into the previous magazine, which is empty
+        if (l.previous && !l.previous->full()) {
+            std::swap (l.loaded, l.previous);
+            return l.loaded->push (p);
+        }
+
+        auto &d { depot[slot - 1] };
+
+        // Hand the full previous magazine to the depot or, if the depot is at its limit, return its elements to the slabs
+        if (l.previous && !d.put_full (l.previous))
+            flush (l.previous);
+
+        // Replace the previous magazine with an empty one
+        else if (!(l.previous = d.get_empty()))
+            l.previous = new Magazine;
+
+        if (EXPECT_TRUE (l.previous)) {
+            std::swap (l.loaded, l.previous);
+            return l.loaded->push (p);
+        }
+    }
+
+    Lock_guard <Spinlock> guard { lock };
+
+    put (p);
+}
@@ -22,7 +22,7 @@
 #include "sm.hpp"
 #include "stdio.hpp"
 
-INIT_PRIORITY (PRIO_SLAB) Slab_cache Sm::cache { sizeof (Sm), Kobject::alignment };
+INIT_PRIORITY (PRIO_SLAB) Slab_cache Sm::cache { sizeof (Sm), Kobject::alignment, true };
 
 Sm::Sm (uint64_t c, unsigned i) : Kobject { Kobject::Type::SM }, counter { c }, id { i }
 {
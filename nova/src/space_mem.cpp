@@ -58,11 +58,17 @@ template<typename T> Status Space_mem<T>::delegate (Space_hst const *hst, unsign
 
         if ((sts = static_cast<T *>(this)->update (d, p, o, pm, ma)) != Status::SUCCESS)
             break;
-    }
 
-    static_cast<T *>(this)->sync();
+        // Collapse fully populated page tables before the TLB invalidation below
+        if (pm)
+            static_cast<T *>(this)->promote (d, o);
+    }
 
-    Buddy::free_wait();
+    // Page tables that stale translations may still reach must never be reused
+    if (EXPECT_TRUE (static_cast<T *>(this)->sync (dsb << PAGE_BITS, dse << PAGE_BITS)))
+        Buddy::free_wait();
+    else
+        Buddy::leak_wait();
 
     return sts;
 }
@@ -20,6 +20,7 @@
  */
 
 #include "buddy.hpp"
+#include "cpu.hpp"
 #include "space_obj.hpp"
 
 INIT_PRIORITY (PRIO_SPACE_OBJ) ALIGNED (Kobject::alignment) Space_obj Space_obj::nova;
@@ -83,16 +84,18 @@ struct Space_obj::Captable
     }
 
     /*
-     * Deallocate a Captable subtree
+     * Deallocate a Captable subtree and release the capabilities in its leaves
      *
      * @param l     Subtree level
      */
     inline void deallocate (unsigned l)
     {
-        if (l)
-            for (unsigned i { 0 }; i < entries; i++)
+        for (unsigned i { 0 }; i < entries; i++)
+            if (l) {
                 if (slot[i])
                     slot[i]->deallocate (l - 1);
+            } else
+                Capability (reinterpret_cast<uintptr_t>(static_cast<Captable *>(slot[i]))).release();
 
         delete this;
     }
@@ -153,6 +156,49 @@ Atomic<Capability> *Space_obj::walk (unsigned long sel, bool e)
     }
 }
 
+/*
+ * Walk capability tables and return pointer to the capability slot for the specified selector without allocating
+ *
+ * @param sel   Selector whose slot is being looked up
+ * @return      Pointer to the capability slot (if exists) or nullptr (hole)
+ */
+Atomic<Capability> const *Space_obj::walk (unsigned long sel) const
+{
+    auto l { lev }; Captable *cte;
+
+    // Walk down the capability tables from the root, computing the slot index at each level
+    for (auto ptr { &root };; ptr = &cte->slot[(sel >> --l * bpl) % Captable::entries]) {
+
+        // Terminate the walk upon reaching the leaf level and return pointer to the capability slot
+        if (!l)
+            return reinterpret_cast<Atomic<Capability> const *>(ptr);
+
+        // Terminate the walk for a hole
+        if (!(cte = *ptr))
+            return nullptr;
+    }
+}
+
+/*
+ * Install OBJ capability into a capability slot
+ *
+ * @param ptr   Pointer to the capability slot
+ * @param cap   New capability for that slot
+ */
+void Space_obj::install (Atomic<Capability> *ptr, Capability cap)
+{
+    Capability old;
+
+    // Try to acquire a reference on the capability object
+    if (cap.acquire())
+        ptr->exchange (old, cap);   // success: replace with capability
+    else
+        ptr->exchange (old, old);   // failure: replace with null capability
+
+    // Release reference on the replaced capability object
+    old.release();
+}
+
 /*
  * Lookup OBJ capability for the specified selector
  *
@@ -192,16 +238,7 @@ Status Space_obj::update (unsigned long sel, Capability cap)
     if (ptr == reinterpret_cast<Atomic<Capability> *>(~0UL))
         return Status::SUCCESS;
 
-    Capability old;
-
-    // Try to acquire a reference on the capability object
-    if (cap.acquire())
-        ptr->exchange (old, cap);   // success: replace with capability
-    else
-        ptr->exchange (old, old);   // failure: replace with null capability
-
-    // Release reference on the replaced capability object
-    old.release();
+    install (ptr, cap);
 
     return Status::SUCCESS;
 }
@@ -256,18 +293,34 @@ Status Space_obj::delegate (Space_obj const *obj, unsigned long const ssb, unsig
     if (EXPECT_FALSE (sse > selectors || dse > selectors))
         return Status::BAD_PAR;
 
-    auto sts { Status::SUCCESS };
+    // Selector bases are aligned to the range size, so no chunk crosses a leaf capability table
+    auto const n { BITN (min (ord, static_cast<unsigned>(max_order))) };
 
-    for (auto src { ssb }, dst { dsb }; src < sse; src++, dst++) {
+    for (auto src { ssb }, dst { dsb }; src < sse; src += n, dst += n) {
 
-        Capability cap { obj->lookup (src) };
+        // Preempt long delegations between chunks
+        if (src != ssb)
+            Cpu::preemption_point();
 
-        auto const o { cap.obj() };
-        auto const p { cap.prm() & pmm };
+        // Walk both capability tables once per chunk. A destination table is only needed if the source table exists
+        auto const s { obj->walk (src) };
+        auto const d { walk (dst, s) };
 
-        if ((sts = update (dst, Capability (o, p))) != Status::SUCCESS)
-            break;
+        // Allocation failure
+        if (EXPECT_FALSE (!d))
+            return Status::MEM_CAP;
+
+        // Skippable hole
+        if (d == reinterpret_cast<Atomic<Capability> *>(~0UL))
+            continue;
+
+        for (unsigned long i { 0 }; i < n; i++) {
+
+            Capability const cap { s ? s[i].load() : Capability() };
+
+            install (d + i, Capability (cap.obj(), cap.prm() & pmm));
+        }
     }
 
-    return sts;
+    return Status::SUCCESS;
 }
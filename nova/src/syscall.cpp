@@ -35,6 +35,7 @@
 #include "space_msr.hpp"
 #include "space_obj.hpp"
 #include "space_pio.hpp"
+#include "statistics.hpp"
 #include "stdio.hpp"
 #include "syscall.hpp"
 #include "syscall_tmp.hpp"
@@ -103,6 +104,8 @@ void Ec::rendezvous (Ec *const ec, cont_t c, cont_t e, uintptr_t ip, uintptr_t i
     if (EXPECT_FALSE (ec->cont))
         return;
 
+    Statistics::cpu().ipc_call.inc();
+
     cont = c;
     set_partner (ec);
 
@@ -126,6 +129,8 @@ void Ec::reply (cont_t c)
 
         assert (subtype == Kobject::Subtype::EC_LOCAL);
 
+        Statistics::cpu().ipc_reply.inc();
+
         if (EXPECT_TRUE (ec->clr_partner()))
             static_cast<Ec_arch *>(ec)->make_current();
 
@@ -151,6 +156,12 @@ template<Ec::cont_t C> void Ec::send_msg (Ec *const self)
     if (EXPECT_FALSE (self->cpu != ec->cpu))
         self->kill ("PT wrong CPU");
 
+    // The call arrived from another CPU
+    if (EXPECT_FALSE (self->hop)) {
+        Statistics::cpu().ipc_xcpu_hop.add (Timer::time() - self->hop);
+        self->hop = 0;
+    }
+
     assert (ec->subtype == Kobject::Subtype::EC_LOCAL);
 
     self->rendezvous (ec, C, recv_kern, pt->get_ip(), pt->get_id(), pt->get_mtd());
@@ -173,8 +184,34 @@ void Ec::sys_ipc_call (Ec *const self)
     auto const pt { static_cast<Pt *>(cpt.obj()) };
     auto const ec { pt->get_ec() };
 
-    if (EXPECT_FALSE (self->cpu != ec->cpu))
-        sys_finish<Status::BAD_CPU> (self);
+    // Carry the call to the CPU of the portal and return after the reply
+    if (EXPECT_FALSE (self->cpu != ec->cpu)) {
+
+        auto const sc { Scheduler::get_current() };
+
+        // Only a host EC running on its own SC can migrate
+        if (EXPECT_FALSE (sc->get_ec() != self))
+            sys_finish<Status::BAD_CPU> (self);
+
+        // The previous migration attempt failed
+        if (EXPECT_FALSE (self->regs.hazard.tas (Hazard::HOME))) {
+            self->regs.hazard.clr (Hazard::HOME);
+            self->hop = 0;
+            sc->migrate (self->cpu);
+            sys_finish<Status::BAD_CPU> (self);
+        }
+
+        Statistics::cpu().ipc_xcpu.inc();
+
+        self->home = self->cpu;
+        self->hop  = Timer::time();
+        self->cont = sys_ipc_call;
+
+        // The SC moves via the release queue of the remote CPU when dispatched next
+        sc->migrate (ec->cpu);
+
+        Scheduler::schedule();
+    }
 
     assert (ec->subtype == Kobject::Subtype::EC_LOCAL);
 
@@ -266,9 +303,9 @@ void Ec::sys_create_sc (Ec *const self)
 {
     Sys_create_sc r { self->sys_regs() };
 
-    trace (TRACE_SYSCALL, "EC:%p %s SEL:%#lx PD:%#lx EC:%#lx P:%u B:%u C:%u", static_cast<void *>(self), __func__, r.sel(), r.pd(), r.ec(), r.prio(), r.budget(), r.cos());
+    trace (TRACE_SYSCALL, "EC:%p %s SEL:%#lx PD:%#lx EC:%#lx P:%u B:%u C:%u T:%u%s", static_cast<void *>(self), __func__, r.sel(), r.pd(), r.ec(), r.prio(), r.budget(), r.cos(), r.period(), r.sporadic() ? "S" : "");
 
-    if (EXPECT_FALSE (!r.prio() || !r.budget() || !Cos::valid_cos (r.cos())))
+    if (EXPECT_FALSE (!r.prio() || !r.budget() || (r.period() && r.period() < r.budget()) || !Cos::valid_cos (r.cos())))
         self->sys_finish_status (Status::BAD_PAR);
 
     auto const obj { self->regs.get_obj() };
@@ -284,10 +321,12 @@ void Ec::sys_create_sc (Ec *const self)
         self->sys_finish_status (Status::BAD_CAP);
 
     Status s;
-    auto const sc { Pd::create_sc (s, obj, r.sel(), ec, ec->cpu, r.budget(), r.prio(), r.cos()) };
+    auto const sc { Pd::create_sc (s, obj, r.sel(), ec, r.budget(), r.prio(), r.cos()) };
 
-    if (EXPECT_TRUE (sc))
+    if (EXPECT_TRUE (sc)) {
+        sc->set_period (Stc::ms_to_ticks (r.period()), r.sporadic());
         Scheduler::unblock (sc);
+    }
 
     self->sys_finish_status (s);
 }
@@ -422,10 +461,45 @@ void Ec::sys_ctrl_sc (Ec *const self)
         self->sys_finish_status (Status::BAD_CAP);
 
     auto const sc { static_cast<Sc *>(csc.obj()) };
+    auto const ec { sc->get_ec() };
+
+    // Validate all requests before applying any of them
+    if (r.migrate()) {
+
+        if (EXPECT_FALSE (r.cpu() >= Cpu::count))
+            self->sys_finish_status (Status::BAD_CPU);
+
+        if (EXPECT_FALSE (ec->subtype != Kobject::Subtype::EC_GLOBAL))
+            self->sys_finish_status (Status::BAD_CAP);
+
+        // The EC cannot follow the SC if other SCs are bound to it
+        if (EXPECT_FALSE (!ec->migratable()))
+            self->sys_finish_status (Status::ABORTED);
+    }
+
+    auto const period { Stc::ms_to_ticks (r.period()) };
+
+    if (EXPECT_FALSE (r.server() && !sc->valid_period (period)))
+        self->sys_finish_status (Status::BAD_PAR);
+
+    if (r.migrate())
+        sc->migrate (static_cast<cpu_t>(r.cpu()));
+
+    if (r.latency())
+        sc->set_latency (r.bound());
+
+    if (r.server())
+        sc->set_period (period, r.sporadic());
+
+    static_assert (sizeof (Sc::Stats) <= sizeof (Utcb));
+
+    if (r.stats())
+        self->get_utcb()->store (&sc->get_stats(), sizeof (Sc::Stats));
 
     r.set_time_ticks (sc->get_used());
 
-    self->sys_finish_status (Status::SUCCESS);
+    // The SC moves when its CPU dispatches it next
+    self->sys_finish_status (r.migrate() && ec->cpu != r.cpu() ? Status::PENDING : Status::SUCCESS);
 }
 
 void Ec::sys_ctrl_pt (Ec *const self)
@@ -502,6 +576,49 @@ void Ec::sys_ctrl_hw (Ec *const self)
         default:            // Invalid Operation
             self->sys_finish_status (Status::BAD_PAR);
 
+        case 10: {          // Trace Mask
+            unsigned o, m { static_cast<unsigned>(r.desc()) };
+
+            // Only events that the trace buffers support can be enabled
+            if (EXPECT_FALSE (m != r.desc() || m & ~trace_ring_mask))
+                self->sys_finish_status (Status::BAD_PAR);
+
+            Trace::mask.exchange (o, m);
+
+            r.set_mask (o);
+
+            self->sys_finish_status (Status::SUCCESS);
+        }
+
+        case 9: {           // Trace Buffer
+            auto const cpu { static_cast<cpu_t>(r.desc()) };
+
+            if (EXPECT_FALSE (cpu >= Cpu::count))
+                self->sys_finish_status (Status::BAD_CPU);
+
+            auto const b { Trace::buffer (cpu) };
+
+            if (EXPECT_FALSE (!b))
+                self->sys_finish_status (Status::MEM_OBJ);
+
+            r.set_trace (Kmem::ptr_to_phys (b), Trace_ring::size);
+
+            self->sys_finish_status (Status::SUCCESS);
+        }
+
+        case 8: {           // Scheduler Load
+            auto const cpu { static_cast<cpu_t>(r.desc()) };
+
+            if (EXPECT_FALSE (cpu >= Cpu::count))
+                self->sys_finish_status (Status::BAD_CPU);
+
+            auto const l { Scheduler::get_load (cpu) };
+
+            r.set_load (l->ready, Statistics::get (cpu)->idle.get());
+
+            self->sys_finish_status (Status::SUCCESS);
+        }
+
         case 7:             // MBA L2 Delay
             self->sys_finish_status (Cos::cfg_mb_thrt (static_cast<uint16_t>(r.desc()), static_cast<uint16_t>(r.desc() >> 16)));
 
@@ -600,3 +717,5 @@ template<Status S, bool T> void Ec::sys_finish (Ec *const self)
 
     self->sys_finish_status (S);
 }
+
+template void Ec::sys_finish<Status::ABORTED, true> (Ec *);
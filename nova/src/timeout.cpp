@@ -17,69 +17,129 @@
  */
 
 #include "assert.hpp"
+#include "std.hpp"
 #include "timeout.hpp"
 #include "timer.hpp"
 
-Timeout *Timeout::list;
+Timeout *Timeout::root;
+
+/*
+ * Meld two heaps; the root with the later expiry becomes the leftmost child of the other
+ */
+Timeout *Timeout::meld (Timeout *a, Timeout *b)
+{
+    assert (a && !a->prev && !a->next);
+    assert (b && !b->prev && !b->next);
+
+    if (b->time < a->time)
+        std::swap (a, b);
+
+    if ((b->next = a->chld))
+        b->next->prev = b;
+
+    b->prev = a;
+    a->chld = b;
+
+    return a;
+}
+
+/*
+ * Meld a list of siblings into a single heap (two-pass, iterative)
+ */
+Timeout *Timeout::merge_pairs (Timeout *c)
+{
+    Timeout *r { nullptr };
+
+    // Pass 1: Meld pairs left to right, stacking the results via next
+    while (c) {
+
+        auto a { c }, b { c->next };
+
+        c = b ? b->next : nullptr;
+
+        a->prev = a->next = nullptr;
+
+        if (b) {
+            b->prev = b->next = nullptr;
+            a = meld (a, b);
+        }
+
+        a->next = r;
+        r = a;
+    }
+
+    Timeout *h { nullptr };
+
+    // Pass 2: Meld the stacked heaps right to left
+    while (r) {
+
+        auto a { r };
+
+        r = r->next;
+
+        a->next = nullptr;
+
+        h = h ? meld (h, a) : a;
+    }
+
+    return h;
+}
 
 void Timeout::enqueue (uint64_t t)
 {
-    assert (this != list);
+    assert (this != root);
     assert (!prev);
     assert (!next);
+    assert (!chld);
 
     time = t;
 
-    Timeout *p { nullptr };
+    if (!root || time < root->time) {
+        root = root ? meld (this, root) : this;
+        sync();
+    } else
+        root = meld (root, this);
+}
 
-    for (auto n { list }; n; p = n, n = n->next)
-        if (n->time >= time)
-            break;
+uint64_t Timeout::dequeue()
+{
+    if (root == this) {
 
-    prev = p;
+        root = chld ? merge_pairs (chld) : nullptr;
+        chld = nullptr;
 
-    if (!p) {
-        next = list;
-        list = this;
         sync();
-    } else {
-        next = p->next;
-        p->next = this;
-    }
 
-    if (next)
-        next->prev = this;
-}
+    } else if (prev) {
 
-uint64_t Timeout::dequeue()
-{
-    if (list == this || prev) {
+        if (prev->chld == this)
+            prev->chld = next;
+        else
+            prev->next = next;
 
         if (next)
             next->prev = prev;
 
-        if (prev)
-            prev->next = next;
+        prev = next = nullptr;
 
-        else {
-            list = next;
-            sync();
+        if (chld) {
+            root = meld (root, merge_pairs (chld));
+            chld = nullptr;
         }
-
-        prev = next = nullptr;
     }
 
-    assert (this != list);
+    assert (this != root);
     assert (!prev);
     assert (!next);
+    assert (!chld);
 
     return time;
 }
 
 void Timeout::check()
 {
-    while (list && list->time <= Timer::time()) {
-        Timeout *t = list;
+    while (root && root->time <= Timer::time()) {
+        Timeout *t = root;
         t->dequeue();
         t->trigger();
     }
@@ -87,8 +147,8 @@ void Timeout::check()
 
 void Timeout::sync()
 {
-    if (list)
-        Timer::set_dln (list->time);
+    if (root)
+        Timer::set_dln (root->time);
     else
         Timer::stop();
 }
@@ -96,9 +156,9 @@ void Timeout::sync()
 uint64_t Timeout::idle()
 {
     // When called from Cpu::halt() there must always be at least one timeout pending
-    assert (list);
+    assert (root);
 
-    auto const t { list->time };
+    auto const t { root->time };
     auto const c { Timer::time() };
 
     return t > c ? Stc::ticks_to_us (t - c) : 0;
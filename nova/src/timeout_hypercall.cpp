@@ -21,5 +21,6 @@
 
 void Timeout_hypercall::trigger()
 {
-    sm->timeout (ec);
+    if (auto const s { sm.load() }; s)
+        s->timeout (ec);
 }
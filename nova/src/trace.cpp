@@ -0,0 +1,95 @@
+/*
+ * Binary Trace Buffer
+ *
+ * Copyright (C) 2019-2024 Udo Steinberg, BedRock Systems, Inc.
+ *
+ * This file is part of the NOVA microhypervisor.
+ *
+ * NOVA is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * NOVA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ */
+
+#include "buddy.hpp"
+#include "cpu.hpp"
+#include "kmem.hpp"
+#include "space_hst.hpp"
+#include "stdio.hpp"
+#include "timer.hpp"
+#include "trace.hpp"
+
+Trace_ring *Trace::ring;
+
+/*
+ * Allocate a trace buffer
+ *
+ * @return      Pointer to the trace buffer (allocation success) or nullptr (allocation failure)
+ */
+void *Trace_ring::operator new (size_t) noexcept
+{
+    static_assert (sizeof (Trace_ring) == size);
+    return Buddy::alloc (ord, Buddy::Fill::BITS0);
+}
+
+/*
+ * Allocate the trace buffer of the current CPU and grant user read access to it
+ */
+void Trace::init()
+{
+    if (ring || !(ring = new Trace_ring))
+        return;
+
+    Space_hst::access_ctrl (Kmem::ptr_to_phys (ring), Trace_ring::size, Paging::Permissions (Paging::U | Paging::R));
+}
+
+/*
+ * Get the trace buffer of the specified CPU
+ *
+ * @param c     CPU
+ * @return      Pointer to the trace buffer (if allocated) or nullptr (otherwise)
+ */
+Trace_ring *Trace::buffer (cpu_t c)
+{
+    return *Kmem::loc_to_glob (c, &ring);
+}
+
+/*
+ * Write a trace record
+ *
+ * Interrupts are masked while the record is written, so that an interrupt
+ * handler on the same CPU cannot claim the same slot.
+ *
+ * @param f     Format string
+ * @param a     Arguments
+ * @param n     Number of arguments
+ */
+void Trace::write (char const *f, uint64_t const *a, unsigned n)
+{
+    // CPU-local data is only accessible on the kernel stack of a CPU
+    if (EXPECT_FALSE (((stackptr() - 1) & ~OFFS_MASK (0)) != MMAP_CPU_DSTK || !ring))
+        return;
+
+    auto const p { Cpu::preemption_save() };
+
+    auto const w { ring->w_idx.load() };
+    auto &r { ring->record[w % Trace_ring::entries] };
+
+    // Order the publication of the previous record before the stores to this slot
+    __atomic_thread_fence (__ATOMIC_RELEASE);
+
+    r.time  = Timer::time();
+    r.event = reinterpret_cast<uintptr_t>(f);
+
+    for (unsigned i { 0 }; i < sizeof (r.arg) / sizeof (*r.arg); i++)
+        r.arg[i] = i < n ? a[i] : 0;
+
+    // Publish the record
+    ring->w_idx = w + 1;
+
+    Cpu::preemption_restore (p);
+}
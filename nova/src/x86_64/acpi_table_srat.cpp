@@ -16,6 +16,7 @@
  */
 
 #include "acpi_table_srat.hpp"
+#include "numa.hpp"
 #include "stdio.hpp"
 
 void Acpi_table_srat::Affinity_lapic::parse() const
@@ -23,6 +24,8 @@ void Acpi_table_srat::Affinity_lapic::parse() const
     // Skip disabled entries
     if (EXPECT_FALSE (!(flags & BIT (0))))
         return;
+
+    Numa::add_processor (id, uint32_t { pxd3 } << 24 | uint32_t { pxd2 } << 16 | uint32_t { pxd1 } << 8 | pxd0);
 }
 
 void Acpi_table_srat::Affinity_x2apic::parse() const
@@ -30,6 +33,8 @@ void Acpi_table_srat::Affinity_x2apic::parse() const
     // Skip disabled entries
     if (EXPECT_FALSE (!(flags & BIT (0))))
         return;
+
+    Numa::add_processor (id, pxd);
 }
 
 void Acpi_table_srat::Affinity_memory::parse() const
@@ -39,6 +44,8 @@ void Acpi_table_srat::Affinity_memory::parse() const
         return;
 
     trace (TRACE_FIRM, "SRAT: %#018lx-%018lx Dom %u", uint64_t { base }, base + size, uint32_t { pxd });
+
+    Numa::add_memory (base, size, pxd);
 }
 
 void Acpi_table_srat::parse() const
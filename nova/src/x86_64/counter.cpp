@@ -23,5 +23,3 @@
 
 Counter Counter::req[NUM_IPI];
 Counter Counter::loc[NUM_LVT];
-Counter Counter::schedule;
-Counter Counter::helping;
@@ -31,11 +31,17 @@
 #include "idt.hpp"
 #include "lapic.hpp"
 #include "mca.hpp"
+#include "numa.hpp"
 #include "pconfig.hpp"
+#include "scheduler.hpp"
 #include "space_hst.hpp"
+#include "statistics.hpp"
+#include "stc.hpp"
 #include "stdio.hpp"
 #include "svm.hpp"
 #include "timeout.hpp"
+#include "timer.hpp"
+#include "trace.hpp"
 #include "tss.hpp"
 #include "vmx.hpp"
 
@@ -44,6 +50,7 @@ cpu_t Cpu::id;
 unsigned Cpu::hazard, Cpu::platform, Cpu::family, Cpu::model, Cpu::stepping, Cpu::patch;
 uint32_t Cpu::cstates, Cpu::topology, Cpu::features[13];
 uint64_t Cpu::csthint;
+uint16_t Cpu::cstlat[8], Cpu::cstcor;
 Cpu::Vendor Cpu::vendor;
 Cpu::State_tsc Cpu::hst_tsc;
 
@@ -335,8 +342,12 @@ void Cpu::setup_cst()
     for (unsigned i { 0 }; i < 7; i++) {
         auto const s { supports (Cstate { 8 * (i + 1) }) };
         csthint |= (s ? i << 4 | (s - 1) : csthint >> 8 * i & BIT_RANGE (7, 0)) << 8 * (i + 1);
+        cstlat[i + 1] = s ? static_cast<uint16_t>(cstparam[i + 1].lat * 8) : cstlat[i];
     }
 
+    // Initially trust the timeout-based residency prediction
+    cstcor = 1024;
+
     auto const ctl { Msr::read (Msr::Reg64::POWER_CTL) };
     auto const cfg { Msr::read (Msr::Reg64::CST_CONFIG) & ~(BIT (31) | BIT (16)) };
 
@@ -410,6 +421,8 @@ void Cpu::init()
 
     enumerate_features (clk, rat, lvl, name);
 
+    Numa::init (topology);
+
     Lapic::init (clk, rat);
 
     if (!Acpi::resume) {
@@ -417,6 +430,8 @@ void Cpu::init()
         Space_hst::nova.loc[id] = Hptp::current();
         Space_hst::nova.loc[id].lookup (MMAP_CPU_DATA, phys, o, ma);
         Hptp::master_map (MMAP_GLB_CPUS + id * PAGE_SIZE (0), phys, 0, Paging::Permissions (Paging::G | Paging::W | Paging::R), ma);
+        Space_hst::nova.loc[id].lookup (MMAP_CPU_STAT, phys, o, ma);
+        Statistics::set (id, static_cast<Statistics *>(Kmem::phys_to_ptr (phys)));
     }
 
     setup_msr();
@@ -433,6 +448,7 @@ void Cpu::init()
     Cos::init();
     Fpu::init();
     Mca::init();
+    Trace::init();
 
     Vmcb::init();
     Vmcs::init();
@@ -461,13 +477,36 @@ void Cpu::halt()
         return;
     }
 
-    // Pick a C-state based on predicted idle residency and exit latency
+    // Predict the idle residency from the next timeout, corrected by how early interrupts ended past idle periods
     auto const i { Timeout::idle() };
-    auto const c { i < 1 ? Cstate::C0 : i < 80 ? Cstate::C1 : i < 120 ? Cstate::C3 : i < 151 ? Cstate::C6 : i < 256 ? Cstate::C7 : i < 339 ? Cstate::C8 : i < 1034 ? Cstate::C9 : Cstate::C10 };
-    auto const h { csthint >> std::to_underlying (c) & BIT_RANGE (7, 0) };
+    auto const p { i * cstcor >> 10 };
+    auto const l { Scheduler::get_latency() };
+
+    // Pick the deepest C-state whose target residency and exit latency fit
+    unsigned c { 0 };
+    while (c < 7 && p >= cstparam[c + 1].res && (!l || cstlat[c + 1] <= l * 8))
+        c++;
+
+    auto const h { csthint >> 8 * c & BIT_RANGE (7, 0) };
+    auto const t { Timer::time() };
 
     asm volatile ("monitor" : : "a" (MMAP_CPU_DSTK), "c" (0), "d" (0));
     asm volatile ("sti; mwait; cli" : : "a" (h), "c" (0));
+
+    auto const a { Stc::ticks_to_us (Timer::time() - t) };
+
+    if (i) {
+
+        // Idle periods that outlast the prediction raise it again, bounded to twice the timeout
+        cstcor = static_cast<uint16_t>(cstcor - (cstcor >> 3) + ((min (a, 2 * i) << 10) / i >> 3));
+
+        // A wakeup by the timeout itself overshoots it by the exit latency of the state
+        if (c && a >= i)
+            cstlat[c] = static_cast<uint16_t>(cstlat[c] - (cstlat[c] >> 3) + min (a - i, 8191UL));
+    }
+
+    Statistics::cpu().cstate[c].inc();
+    Statistics::cpu().residency[min (max (bit_scan_reverse (a), 0) / 2, 7)].inc();
 }
 
 void Cpu::allocate (apic_t i)
@@ -53,7 +53,7 @@ Ec_arch::Ec_arch (bool t, Fpu *f, Refptr<Space_obj> &ref_obj, Refptr<Space_hst>
     exc_regs().set_ep (Event::hst_arch + Event::Selector::STARTUP);
 
     // Map UTCB
-    hst->update (hva, Kmem::ptr_to_phys (kpage), 0, Paging::Permissions (Paging::K | Paging::U | Paging::W | Paging::R), Memattr::ram());
+    hst->update (kmap = hva, Kmem::ptr_to_phys (kpage), 0, Paging::Permissions (Paging::K | Paging::U | Paging::W | Paging::R), Memattr::ram());
 }
 
 // Constructor: GST EC (VMX)
@@ -74,11 +74,12 @@ Ec_arch::Ec_arch (bool t, Fpu *f, Refptr<Space_obj> &ref_obj, Refptr<Space_hst>
 
     auto const cr3 { Kmem::ptr_to_phys (hst->get_ptab (c)) | (Cpu::feature (Cpu::Feature::PCID) ? hst->get_pcid() : 0) };
 
-    v->init (sp, reinterpret_cast<uintptr_t>(&sys_regs() + 1), cr3, Kmem::ptr_to_phys (kpage), Vpid::alloc (cpu));
+    v->init (sp, reinterpret_cast<uintptr_t>(&sys_regs() + 1), cr3, Kmem::ptr_to_phys (kpage));
 
     assert (regs.vmcs == Vmcs::current);
 
     exc_regs().offset_tsc = 0;
+    exc_regs().knl_exit   = 0;
     exc_regs().intcpt_cr0 = 0;
     exc_regs().intcpt_cr4 = 0;
     exc_regs().intcpt_exc = 0;
@@ -97,7 +98,7 @@ Ec_arch::Ec_arch (bool t, Fpu *f, Refptr<Space_obj> &ref_obj, Refptr<Space_hst>
     exc_regs().set_ep (Event::gst_arch + Event::Selector::STARTUP);
 
     // Map vAPIC page
-    hst->update (hva, Kmem::ptr_to_phys (kpage), 0, Paging::Permissions (Paging::K | Paging::U | Paging::W | Paging::R), Memattr::ram());
+    hst->update (kmap = hva, Kmem::ptr_to_phys (kpage), 0, Paging::Permissions (Paging::K | Paging::U | Paging::W | Paging::R), Memattr::ram());
 }
 
 // Constructor: GST EC (SVM)
@@ -115,6 +116,7 @@ Ec_arch::Ec_arch (bool t, Fpu *f, Refptr<Space_obj> &ref_obj, Refptr<Space_hst>
 #endif
 
     exc_regs().offset_tsc = 0;
+    exc_regs().knl_exit   = 0;
     exc_regs().intcpt_cr0 = 0;
     exc_regs().intcpt_cr4 = 0;
     exc_regs().intcpt_exc = 0;
@@ -183,6 +185,39 @@ Ec *Ec::create_gst (Status &s, Pd *pd, bool t, bool fpu, cpu_t cpu, unsigned lon
     return nullptr;
 }
 
+/*
+ * Destroy an EC (runs on the CPU of the EC)
+ */
+void Ec::destroy()
+{
+    auto const hst { regs.get_hst() };
+
+    if (fpu)
+        Fpu::operator delete (fpu, hst->get_pd()->fpu_cache);
+
+    // The UTCB or vLAPIC page is freed with the host space if it is still mapped there
+    if (kpage) {
+
+        uint64_t p; unsigned o; Memattr ma;
+
+        if (!(hst->lookup (kmap, p, o, ma) & Paging::K) || p != Kmem::ptr_to_phys (kpage))
+            Buddy::free (kpage);
+    }
+
+    if (is_vcpu()) {
+
+        if (Hip::feature (Hip_arch::Feature::VMX)) {
+            regs.vmcs->clear();
+            delete regs.vmcs;
+        } else
+            delete regs.vmcb;
+    }
+
+    this->~Ec();
+
+    operator delete (this, cache);
+}
+
 void Ec::adjust_offset_ticks (uint64_t t)
 {
     if (subtype == Kobject::Subtype::EC_VCPU_OFFS) {
@@ -191,25 +226,28 @@ void Ec::adjust_offset_ticks (uint64_t t)
     }
 }
 
-void Ec::handle_hazard (unsigned h, cont_t func)
+void Ec::handle_hazard (unsigned h, cont_t resume)
 {
     if (h & Hazard::RCU)
         Rcu::quiet();
 
-    if (EXPECT_FALSE (h & (Hazard::ILLEGAL | Hazard::RECALL | Hazard::SLEEP | Hazard::SCHED))) {
+    if (EXPECT_FALSE (h & (Hazard::ILLEGAL | Hazard::RECALL | Hazard::HOME | Hazard::SLEEP | Hazard::SCHED))) {
 
         Cpu::preemption_point();
 
         if (Cpu::hazard & Hazard::SLEEP) {      // Reload
-            cont = func;
+            cont = resume;
             Cpu::fini();
         }
 
         if (Cpu::hazard & Hazard::SCHED) {      // Reload
-            cont = func;
+            cont = resume;
             Scheduler::schedule();
         }
 
+        if (regs.hazard & Hazard::HOME)         // Reload
+            return_home (resume);
+
         if (h & Hazard::ILLEGAL)
             kill ("Illegal execution state");
 
@@ -217,17 +255,17 @@ void Ec::handle_hazard (unsigned h, cont_t func)
 
             regs.hazard.clr (Hazard::RECALL);
 
-            if (func == Ec_arch::ret_user_vmexit_vmx) {
+            if (resume == Ec_arch::ret_user_vmexit_vmx) {
                 exc_regs().set_ep (Event::gst_arch + Event::Selector::RECALL);
                 send_msg<Ec_arch::ret_user_vmexit_vmx> (this);
             }
 
-            if (func == Ec_arch::ret_user_vmexit_svm) {
+            if (resume == Ec_arch::ret_user_vmexit_svm) {
                 exc_regs().set_ep (Event::gst_arch + Event::Selector::RECALL);
                 send_msg<Ec_arch::ret_user_vmexit_svm> (this);
             }
 
-            if (func == Ec_arch::ret_user_hypercall)
+            if (resume == Ec_arch::ret_user_hypercall)
                 static_cast<Ec_arch *>(this)->redirect_to_iret();
 
             exc_regs().set_ep (Event::hst_arch + Event::Selector::RECALL);
@@ -241,7 +279,7 @@ void Ec::handle_hazard (unsigned h, cont_t func)
 
         regs.hazard.clr (Hazard::TSC);
 
-        if (func == Ec_arch::ret_user_vmexit_vmx) {
+        if (resume == Ec_arch::ret_user_vmexit_vmx) {
             regs.vmcs->make_current();
             Vmcs::write (Vmcs::Encoding::TSC_OFFSET, regs.exc.offset_tsc);
         } else
@@ -254,7 +292,7 @@ void Ec::handle_hazard (unsigned h, cont_t func)
 
 void Ec_arch::ret_user_hypercall (Ec *const self)
 {
-    auto const h { (Cpu::hazard ^ self->regs.hazard) & (Hazard::ILLEGAL | Hazard::RECALL | Hazard::FPU | Hazard::RCU | Hazard::SLEEP | Hazard::SCHED) };
+    auto const h { (Cpu::hazard ^ self->regs.hazard) & (Hazard::ILLEGAL | Hazard::RECALL | Hazard::HOME | Hazard::FPU | Hazard::RCU | Hazard::SLEEP | Hazard::SCHED) };
     if (EXPECT_FALSE (h))
         self->handle_hazard (h, ret_user_hypercall);
 
@@ -286,6 +324,9 @@ void Ec_arch::ret_user_vmexit_vmx (Ec *const self)
 
     self->regs.vmcs->make_current();
 
+    if (EXPECT_FALSE (!Vpid::valid (self->regs.vpid_gen)) && Vmcs::has_vpid())
+        Vmcs::write (Vmcs::Encoding::VPID, Vpid::alloc (self->regs.vpid_gen));
+
     auto const gst { self->regs.get_gst() };
 
     if (EXPECT_FALSE (gst->gtlb.tst (Cpu::id))) {
@@ -24,6 +24,7 @@
 #include "fpu.hpp"
 #include "gdt.hpp"
 #include "mca.hpp"
+#include "statistics.hpp"
 
 void Ec::fpu_load()
 {
@@ -102,6 +103,7 @@ void Ec_arch::handle_exc (Exc_regs *r)
             break;
 
         case EXC_PF:
+            Statistics::cpu().page_fault.inc();
             if (static_cast<Ec_arch *>(self)->handle_exc_pf (r))
                 return;
             break;
@@ -20,6 +20,7 @@
  */
 
 #include "ec_arch.hpp"
+#include "statistics.hpp"
 #include "svm.hpp"
 
 void Ec_arch::svm_exception (uint64_t reason)
@@ -68,6 +69,9 @@ void Ec_arch::handle_svm()
             break;
     }
 
+    if (EXPECT_TRUE (reason < Event::gst_arch))
+        Statistics::cpu().vmexit[reason].inc();
+
     switch (reason) {
 
         case 0x40 ... 0x5f:     // Exception
@@ -22,7 +22,9 @@
 #include "counter.hpp"
 #include "ec_arch.hpp"
 #include "interrupt.hpp"
+#include "statistics.hpp"
 #include "stdio.hpp"
+#include "timer.hpp"
 #include "vmx.hpp"
 
 void Ec_arch::vmx_exception()
@@ -66,6 +68,174 @@ void Ec_arch::vmx_extint()
     ret_user_vmexit_vmx (this);
 }
 
+/*
+ * Read an MSR whose guest value the kernel holds
+ *
+ * @param idx   MSR index
+ * @param val   MSR value (output)
+ * @return      True if the MSR is on the allowlist, false otherwise
+ */
+bool Ec_arch::vmx_rdmsr (uint32_t idx, uint64_t &val) const
+{
+    switch (static_cast<Msr::Reg64>(idx)) {
+        case Msr::Reg64::IA32_SYSENTER_CS:      val = Vmcs::read<uint32_t> (Vmcs::Encoding::GUEST_SYSENTER_CS);  return true;
+        case Msr::Reg64::IA32_SYSENTER_ESP:     val = Vmcs::read<uint64_t> (Vmcs::Encoding::GUEST_SYSENTER_ESP); return true;
+        case Msr::Reg64::IA32_SYSENTER_EIP:     val = Vmcs::read<uint64_t> (Vmcs::Encoding::GUEST_SYSENTER_EIP); return true;
+        case Msr::Reg64::IA32_STAR:             val = regs.gst_sys.star;            return true;
+        case Msr::Reg64::IA32_LSTAR:            val = regs.gst_sys.lstar;           return true;
+        case Msr::Reg64::IA32_FMASK:            val = regs.gst_sys.fmask;           return true;
+        case Msr::Reg64::IA32_KERNEL_GS_BASE:   val = regs.gst_sys.kernel_gs_base;  return true;
+        case Msr::Reg64::IA32_TSC_AUX:          val = regs.gst_tsc.tsc_aux;         return true;
+        default:                                return false;
+    }
+}
+
+/*
+ * Write an MSR whose guest value the kernel holds
+ *
+ * Values that would fault on real hardware are left to the VMM.
+ *
+ * @param idx   MSR index
+ * @param val   MSR value
+ * @return      True if the MSR is on the allowlist and the value is valid, false otherwise
+ */
+bool Ec_arch::vmx_wrmsr (uint32_t idx, uint64_t val)
+{
+    switch (static_cast<Msr::Reg64>(idx)) {
+
+        case Msr::Reg64::IA32_SYSENTER_CS:
+            if (val >> 32)
+                return false;
+            Vmcs::write (Vmcs::Encoding::GUEST_SYSENTER_CS, val);
+            return true;
+
+        case Msr::Reg64::IA32_SYSENTER_ESP:
+            if (val != Cpu::State_sys::constrain_canon (val))
+                return false;
+            Vmcs::write (Vmcs::Encoding::GUEST_SYSENTER_ESP, val);
+            return true;
+
+        case Msr::Reg64::IA32_SYSENTER_EIP:
+            if (val != Cpu::State_sys::constrain_canon (val))
+                return false;
+            Vmcs::write (Vmcs::Encoding::GUEST_SYSENTER_EIP, val);
+            return true;
+
+        case Msr::Reg64::IA32_STAR:
+            if (val != Cpu::State_sys::constrain_star (val))
+                return false;
+            regs.gst_sys.star = val;
+            return true;
+
+        case Msr::Reg64::IA32_LSTAR:
+            if (val != Cpu::State_sys::constrain_canon (val))
+                return false;
+            regs.gst_sys.lstar = val;
+            return true;
+
+        case Msr::Reg64::IA32_FMASK:
+            if (val != Cpu::State_sys::constrain_fmask (val))
+                return false;
+            regs.gst_sys.fmask = val;
+            return true;
+
+        case Msr::Reg64::IA32_KERNEL_GS_BASE:
+            if (val != Cpu::State_sys::constrain_canon (val))
+                return false;
+            regs.gst_sys.kernel_gs_base = val;
+            return true;
+
+        case Msr::Reg64::IA32_TSC_AUX:
+            if (val != Cpu::State_tsc::constrain_tsc_aux (val))
+                return false;
+            regs.gst_tsc.tsc_aux = val;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/*
+ * Complete a trivial VM exit in the kernel if the in-kernel exit policy permits it
+ *
+ * Anything unusual (single-stepping, invalid operands, MSRs outside the allowlist) goes to the VMM.
+ *
+ * @param reason    VM exit reason
+ * @return          True if the exiting instruction was completed, false otherwise
+ */
+bool Ec_arch::vmx_trivial (unsigned reason)
+{
+    auto const pol { exc_regs().knl_exit };
+    auto &s { exc_regs().sys };
+
+    // Single-stepping requires a #DB after the instruction
+    if (Vmcs::read<uintptr_t> (Vmcs::Encoding::GUEST_RFLAGS) & RFL_TF)
+        return false;
+
+    switch (reason) {
+
+        case Vmcs::VMX_RDTSC:
+            if (!(pol & Utcb_arch::Exit::RDTSC))
+                return false;
+            {   auto const tsc { Timer::time() + exc_regs().offset_tsc };
+                s.rax = static_cast<uint32_t>(tsc);
+                s.rdx = static_cast<uint32_t>(tsc >> 32);
+            }
+            break;
+
+        case Vmcs::VMX_RDTSCP:
+            if (!(pol & Utcb_arch::Exit::RDTSCP))
+                return false;
+            {   auto const tsc { Timer::time() + exc_regs().offset_tsc };
+                s.rax = static_cast<uint32_t>(tsc);
+                s.rdx = static_cast<uint32_t>(tsc >> 32);
+                s.rcx = static_cast<uint32_t>(regs.gst_tsc.tsc_aux);
+            }
+            break;
+
+        case Vmcs::VMX_PAUSE:
+            if (!(pol & Utcb_arch::Exit::PAUSE))
+                return false;
+            break;
+
+        case Vmcs::VMX_XSETBV:
+            if (!(pol & Utcb_arch::Exit::XSETBV))
+                return false;
+            {   auto const xcr { static_cast<uint64_t>(s.rdx) << 32 | static_cast<uint32_t>(s.rax) };
+                if (static_cast<uint32_t>(s.rcx) || xcr != Fpu::State_xsv::constrain_xcr (xcr))
+                    return false;
+                regs.gst_xsv.xcr = xcr;
+            }
+            break;
+
+        case Vmcs::VMX_RDMSR:
+            if (!(pol & Utcb_arch::Exit::MSR))
+                return false;
+            {   uint64_t val;
+                if (!vmx_rdmsr (static_cast<uint32_t>(s.rcx), val))
+                    return false;
+                s.rax = static_cast<uint32_t>(val);
+                s.rdx = static_cast<uint32_t>(val >> 32);
+            }
+            break;
+
+        case Vmcs::VMX_WRMSR:
+            if (!(pol & Utcb_arch::Exit::MSR) || !vmx_wrmsr (static_cast<uint32_t>(s.rcx), static_cast<uint64_t>(s.rdx) << 32 | static_cast<uint32_t>(s.rax)))
+                return false;
+            break;
+
+        default:
+            return false;
+    }
+
+    // Skip the instruction, which also ends any STI or MOV SS blocking
+    Vmcs::write (Vmcs::Encoding::GUEST_RIP, Vmcs::read<uintptr_t> (Vmcs::Encoding::GUEST_RIP) + Vmcs::read<uint32_t> (Vmcs::Encoding::EXI_INST_LEN));
+    Vmcs::write (Vmcs::Encoding::GUEST_INTR_STATE, Vmcs::read<uint32_t> (Vmcs::Encoding::GUEST_INTR_STATE) & ~BIT_RANGE (1, 0));
+
+    return true;
+}
+
 void Ec_arch::handle_vmx()
 {
     Ec *const self { current };
@@ -81,11 +251,16 @@ void Ec_arch::handle_vmx()
 
     auto reason { Vmcs::read<uint32_t> (Vmcs::Encoding::EXI_REASON) & BIT_RANGE (7, 0) };
 
+    Statistics::cpu().vmexit[reason].inc();
+
     switch (reason) {
         case Vmcs::VMX_EXC_NMI:     static_cast<Ec_arch *>(self)->vmx_exception();
         case Vmcs::VMX_EXTINT:      static_cast<Ec_arch *>(self)->vmx_extint();
     }
 
+    if (self->exc_regs().knl_exit && static_cast<Ec_arch *>(self)->vmx_trivial (reason))
+        ret_user_vmexit_vmx (self);
+
     self->exc_regs().set_ep (reason);
 
     send_msg<ret_user_vmexit_vmx> (self);
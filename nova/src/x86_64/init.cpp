@@ -61,6 +61,10 @@ extern "C" uintptr_t kern_ptab_setup (apic_t t)
     hptp.update (MMAP_CPU_DSTK, Kmem::ptr_to_phys (Buddy::alloc (0, Buddy::Fill::BITS0)), 0,
                  Paging::Permissions (Paging::G | Paging::W | Paging::R), Memattr::ram());
 
+    // Allocate and map statistics page
+    hptp.update (MMAP_CPU_STAT, Kmem::ptr_to_phys (Buddy::alloc (0, Buddy::Fill::BITS0)), 0,
+                 Paging::Permissions (Paging::G | Paging::W | Paging::R), Memattr::ram());
+
     return hptp.root_addr();
 }
 
@@ -95,6 +99,9 @@ extern "C" void init()
 
     Acpi::init();
 
+    if (!Acpi::resume)
+        Buddy::partition();
+
     Pic::init();
 
     Ioapic::init_all();
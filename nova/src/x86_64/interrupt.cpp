@@ -27,9 +27,9 @@
 #include "lapic.hpp"
 #include "sm.hpp"
 #include "smmu.hpp"
-#include "space_hst.hpp"
 #include "space_obj.hpp"
 #include "stdio.hpp"
+#include "tlb.hpp"
 #include "vectors.hpp"
 
 Interrupt Interrupt::int_table[NUM_GSI];
@@ -58,8 +58,7 @@ void Interrupt::rke_handler()
     if (Acpi::get_transition().state())
         Cpu::hazard |= Hazard::SLEEP;
 
-    if (Space_hst::current->htlb.tst (Cpu::id))
-        Cpu::hazard |= Hazard::SCHED;
+    Tlb::handler();
 }
 
 void Interrupt::handle_ipi (unsigned ipi)
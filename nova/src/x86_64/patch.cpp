@@ -20,7 +20,6 @@
 #include "memattr.hpp"
 #include "patch.hpp"
 #include "ptab_hpt.hpp"
-#include "string.hpp"
 #include "util.hpp"
 
 void Patch::detect()
@@ -45,6 +44,7 @@ void Patch::detect()
                 }
             }
             skipped |= !!(edx & BIT (20)) * BIT (PATCH_CET_IBT);
+            skipped |= !!(ebx & BIT (9) || edx & BIT (4)) * BIT (PATCH_ERMS);
             Cpu::cpuid (0x7, 0x1, eax, ebx, ecx, edx);
             skipped |= !!(edx & BIT (18)) * BIT (PATCH_CET_SSS);
             [[fallthrough]];
@@ -81,10 +81,11 @@ void Patch::init()
         if (skipped & BIT (p->tag))
             continue;
 
-        auto const o { reinterpret_cast<uint8_t *>(p) + p->off_old };
-        auto const n { reinterpret_cast<uint8_t *>(p) + p->off_new };
+        auto const o { reinterpret_cast<uint8_t volatile *>(p) + p->off_old };
+        auto const n { reinterpret_cast<uint8_t const *>(p) + p->off_new };
 
-        memcpy (o, n, p->len_new);
-        memset (o + p->len_new, NOP_OPC, p->len_old - p->len_new);
+        // Copy byte by byte, because memcpy and memset are patch sites themselves
+        for (unsigned i { 0 }; i < p->len_old; i++)
+            o[i] = i < p->len_new ? n[i] : NOP_OPC;
     }
 }
@@ -0,0 +1,251 @@
+/*
+ * Secure Hash Algorithm (SHA): Architecture-Specific Part (x86)
+ *
+ * Copyright (C) 2019-2024 Udo Steinberg, BedRock Systems, Inc.
+ *
+ * This file is part of the NOVA microhypervisor.
+ *
+ * NOVA is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * NOVA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ */
+
+#include <immintrin.h>
+
+#include "cpu.hpp"
+#include "sha_arch.hpp"
+#include "stdio.hpp"
+
+/*
+ * SHA-1: 4 rounds per group G with the SHA extensions
+ *
+ * @param w     Message schedule (4 groups)
+ * @param abcd  Working variables A, B, C, D
+ * @param e     Working variable E for the current (G % 2) and the next group
+ */
+template<unsigned G> TARGET ("sha,sse4.1") ALWAYS_INLINE
+static inline void sha1_rounds (__m128i (&w)[4], __m128i &abcd, __m128i (&e)[2])
+{
+    if constexpr (G == 0)
+        e[0] = _mm_add_epi32 (e[0], w[0]);
+    else
+        e[G % 2] = _mm_sha1nexte_epu32 (e[G % 2], w[G % 4]);
+
+    e[(G + 1) % 2] = abcd;
+
+    if constexpr (G >= 3 && G <= 18)
+        w[(G + 1) % 4] = _mm_sha1msg2_epu32 (w[(G + 1) % 4], w[G % 4]);
+
+    abcd = _mm_sha1rnds4_epu32 (abcd, e[G % 2], G / 5);
+
+    if constexpr (G >= 1 && G <= 16)
+        w[(G + 3) % 4] = _mm_sha1msg1_epu32 (w[(G + 3) % 4], w[G % 4]);
+
+    if constexpr (G >= 2 && G <= 17)
+        w[(G + 2) % 4] = _mm_xor_si128 (w[(G + 2) % 4], w[G % 4]);
+
+    if constexpr (G < 19)
+        sha1_rounds<G + 1> (w, abcd, e);
+}
+
+/*
+ * SHA-256: 4 rounds per group G with the SHA extensions
+ *
+ * @param w     Message schedule (4 groups)
+ * @param abef  Working variables A, B, E, F
+ * @param cdgh  Working variables C, D, G, H
+ * @param k     Round constants
+ */
+template<unsigned G> TARGET ("sha,sse4.1") ALWAYS_INLINE
+static inline void sha2_rounds (__m128i (&w)[4], __m128i &abef, __m128i &cdgh, uint32_t const *k)
+{
+    auto t { _mm_add_epi32 (w[G % 4], _mm_load_si128 (reinterpret_cast<__m128i const *>(k + 4 * G))) };
+
+    cdgh = _mm_sha256rnds2_epu32 (cdgh, abef, t);
+
+    if constexpr (G >= 3 && G <= 14)
+        w[(G + 1) % 4] = _mm_sha256msg2_epu32 (_mm_add_epi32 (w[(G + 1) % 4], _mm_alignr_epi8 (w[G % 4], w[(G + 3) % 4], 4)), w[G % 4]);
+
+    abef = _mm_sha256rnds2_epu32 (abef, cdgh, _mm_shuffle_epi32 (t, 0xe));
+
+    if constexpr (G >= 1 && G <= 12)
+        w[(G + 3) % 4] = _mm_sha256msg1_epu32 (w[(G + 3) % 4], w[G % 4]);
+
+    if constexpr (G < 15)
+        sha2_rounds<G + 1> (w, abef, cdgh, k);
+}
+
+TARGET ("avx") ALWAYS_INLINE
+static inline __m128i ror (__m128i x, int n)
+{
+    return _mm_or_si128 (_mm_srli_epi64 (x, n), _mm_slli_epi64 (x, 64 - n));
+}
+
+/*
+ * SHA-512: 1 round for two hash values (one per 64-bit lane)
+ *
+ * The caller rotates the working variables by passing them in a different order
+ */
+TARGET ("avx") ALWAYS_INLINE
+static inline void sha2_round (__m128i a, __m128i b, __m128i c, __m128i &d, __m128i e, __m128i f, __m128i g, __m128i &h, uint64_t kw)
+{
+    auto const sum0 { _mm_xor_si128 (_mm_xor_si128 (ror (a, 28), ror (a, 34)), ror (a, 39)) };
+    auto const sum1 { _mm_xor_si128 (_mm_xor_si128 (ror (e, 14), ror (e, 18)), ror (e, 41)) };
+    auto const chx  { _mm_xor_si128 (_mm_and_si128 (e, f), _mm_andnot_si128 (e, g)) };
+    auto const maj  { _mm_or_si128 (_mm_and_si128 (_mm_or_si128 (a, b), c), _mm_and_si128 (a, b)) };
+
+    auto const t1 { _mm_add_epi64 (_mm_add_epi64 (_mm_add_epi64 (h, sum1), chx), _mm_set1_epi64x (static_cast<long long>(kw))) };
+
+    d = _mm_add_epi64 (d, t1);
+    h = _mm_add_epi64 (_mm_add_epi64 (t1, sum0), maj);
+}
+
+/*
+ * SHA-1 with the SHA extensions
+ */
+void Sha_arch::sha1 (uint32_t *h, uint8_t const *m, size_t n)
+{
+    auto const bswap { _mm_set_epi64x (0x0001020304050607, 0x08090a0b0c0d0e0f) };
+
+    auto abcd { _mm_shuffle_epi32 (_mm_loadu_si128 (reinterpret_cast<__m128i const *>(h)), 0x1b) };
+    auto e    { _mm_set_epi32 (static_cast<int>(h[4]), 0, 0, 0) };
+
+    for (; n--; m += 64) {
+
+        __m128i w[4], v[2] { e, e };
+
+        for (unsigned i { 0 }; i < 4; i++)
+            w[i] = _mm_shuffle_epi8 (_mm_loadu_si128 (reinterpret_cast<__m128i const *>(m) + i), bswap);
+
+        auto const s { abcd };
+
+        sha1_rounds<0> (w, abcd, v);
+
+        e    = _mm_sha1nexte_epu32 (v[0], e);
+        abcd = _mm_add_epi32 (abcd, s);
+    }
+
+    _mm_storeu_si128 (reinterpret_cast<__m128i *>(h), _mm_shuffle_epi32 (abcd, 0x1b));
+
+    h[4] = static_cast<uint32_t>(_mm_extract_epi32 (e, 3));
+}
+
+/*
+ * SHA-256 with the SHA extensions
+ */
+void Sha_arch::sha2 (uint32_t *h, uint8_t const *m, size_t n)
+{
+    struct K { alignas (16) uint32_t v[64]; };
+
+    static constexpr K k { [] { K r { }; for (unsigned i { 0 }; i < 64; i++) r.v[i] = static_cast<uint32_t>(Sha::cbr[i] >> 32); return r; }() };
+
+    auto const bswap { _mm_set_epi64x (0x0c0d0e0f08090a0b, 0x0405060700010203) };
+
+    auto const dcba { _mm_shuffle_epi32 (_mm_loadu_si128 (reinterpret_cast<__m128i const *>(h)),     0xb1) };
+    auto const hgfe { _mm_shuffle_epi32 (_mm_loadu_si128 (reinterpret_cast<__m128i const *>(h) + 1), 0x1b) };
+
+    auto abef { _mm_alignr_epi8 (dcba, hgfe, 8) };
+    auto cdgh { _mm_blend_epi16 (hgfe, dcba, 0xf0) };
+
+    for (; n--; m += 64) {
+
+        __m128i w[4];
+
+        for (unsigned i { 0 }; i < 4; i++)
+            w[i] = _mm_shuffle_epi8 (_mm_loadu_si128 (reinterpret_cast<__m128i const *>(m) + i), bswap);
+
+        auto const s0 { abef }, s1 { cdgh };
+
+        sha2_rounds<0> (w, abef, cdgh, k.v);
+
+        abef = _mm_add_epi32 (abef, s0);
+        cdgh = _mm_add_epi32 (cdgh, s1);
+    }
+
+    auto const feba { _mm_shuffle_epi32 (abef, 0x1b) };
+    auto const dchg { _mm_shuffle_epi32 (cdgh, 0xb1) };
+
+    _mm_storeu_si128 (reinterpret_cast<__m128i *>(h),     _mm_blend_epi16 (feba, dchg, 0xf0));
+    _mm_storeu_si128 (reinterpret_cast<__m128i *>(h) + 1, _mm_alignr_epi8 (dchg, feba, 8));
+}
+
+/*
+ * SHA-384/512 for two hash values over the same message with AVX
+ *
+ * The message schedule is computed once and the rounds for both hash values run in the two 64-bit lanes.
+ */
+void Sha_arch::sha2 (uint64_t *h0, uint64_t *h1, uint8_t const *m, size_t n)
+{
+    __m128i s[8];
+
+    for (unsigned i { 0 }; i < 8; i++)
+        s[i] = _mm_set_epi64x (static_cast<long long>(h1[i]), static_cast<long long>(h0[i]));
+
+    for (; n--; m += 128) {
+
+        uint64_t w[80];
+
+        for (unsigned i { 0 }; i < 16; i++)
+            w[i] = reinterpret_cast<Unaligned_be<uint64_t> const *>(m)[i];
+
+        for (unsigned i { 16 }; i < 80; i++)
+            w[i] = Sha::sig1 (w[i - 2]) + w[i - 7] + Sha::sig0 (w[i - 15]) + w[i - 16];
+
+        auto a { s[0] }, b { s[1] }, c { s[2] }, d { s[3] }, e { s[4] }, f { s[5] }, g { s[6] }, h { s[7] };
+
+        for (unsigned i { 0 }; i < 80; i += 8) {
+            sha2_round (a, b, c, d, e, f, g, h, Sha::cbr[i + 0] + w[i + 0]);
+            sha2_round (h, a, b, c, d, e, f, g, Sha::cbr[i + 1] + w[i + 1]);
+            sha2_round (g, h, a, b, c, d, e, f, Sha::cbr[i + 2] + w[i + 2]);
+            sha2_round (f, g, h, a, b, c, d, e, Sha::cbr[i + 3] + w[i + 3]);
+            sha2_round (e, f, g, h, a, b, c, d, Sha::cbr[i + 4] + w[i + 4]);
+            sha2_round (d, e, f, g, h, a, b, c, Sha::cbr[i + 5] + w[i + 5]);
+            sha2_round (c, d, e, f, g, h, a, b, Sha::cbr[i + 6] + w[i + 6]);
+            sha2_round (b, c, d, e, f, g, h, a, Sha::cbr[i + 7] + w[i + 7]);
+        }
+
+        s[0] = _mm_add_epi64 (s[0], a);
+        s[1] = _mm_add_epi64 (s[1], b);
+        s[2] = _mm_add_epi64 (s[2], c);
+        s[3] = _mm_add_epi64 (s[3], d);
+        s[4] = _mm_add_epi64 (s[4], e);
+        s[5] = _mm_add_epi64 (s[5], f);
+        s[6] = _mm_add_epi64 (s[6], g);
+        s[7] = _mm_add_epi64 (s[7], h);
+    }
+
+    for (unsigned i { 0 }; i < 8; i++) {
+        h0[i] = static_cast<uint64_t>(_mm_cvtsi128_si64 (s[i]));
+        h1[i] = static_cast<uint64_t>(_mm_extract_epi64 (s[i], 1));
+    }
+}
+
+/*
+ * Select the block functions for the features of this CPU
+ *
+ * @return      True if any selected function uses SIMD registers, false otherwise
+ */
+bool Sha_arch::init()
+{
+    bool simd { false };
+
+    if (Cpu::feature (Cpu::Feature::SHA) && Cpu::feature (Cpu::Feature::SSE4_1)) {
+        Sha::block<uint32_t>[0] = sha1;
+        Sha::block<uint32_t>[1] = sha2;
+        simd = true;
+    }
+
+    if (Cpu::feature (Cpu::Feature::AVX) && Cpu::feature (Cpu::Feature::XSAVE)) {
+        Sha::dual<uint64_t> = sha2;
+        simd = true;
+    }
+
+    trace (TRACE_CPU, "SHA: SHA-1/256:%s SHA-384/512:%s", Cpu::feature (Cpu::Feature::SHA) ? "SHA-NI" : "GPR", Sha::dual<uint64_t> ? "AVX" : "GPR");
+
+    return simd;
+}
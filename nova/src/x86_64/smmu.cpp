@@ -68,6 +68,11 @@ void Smmu::init()
     write (Reg32::FSTS, Fault::ITE | Fault::ICE | Fault::IQE | Fault::APF | Fault::AFO | Fault::PFO);
 
     if (feature (Ecap::QI)) {
+
+        // The queue restarts empty, also on resume, and batches pending at suspend are gone
+        invq_idx = invq_hdx = 0;
+        invq_ack = invq_seq.load();
+
         write (Reg64::IQT, 0);
         write (Reg64::IQA, Kmem::ptr_to_phys (invq));
         command (Cmd::QIE);
@@ -43,6 +43,24 @@ Space_hst::Space_hst() : Space_mem { Kobject::Subtype::HST }
     access_ctrl (e, BIT64 (min (Memattr::obits, Hpt::ibits - 1)) - e, Paging::Permissions (Paging::U | Paging::API));
 }
 
+/*
+ * Destructor
+ *
+ * The CPU-local page tables share the user half with hptp and the kernel half
+ * with the NOVA space, so only their private tables are deallocated. Kernel
+ * memory that is still mapped into the space (UTCB, vLAPIC) is freed with it.
+ */
+Space_hst::~Space_hst()
+{
+    for (cpu_t cpu { 0 }; cpu < Cpu::count; cpu++)
+        if (cpus.tst (cpu))
+            loc[cpu].destroy (hptp);
+
+    hptp.destroy (true);
+
+    Buddy::free_wait();
+}
+
 void Space_hst::init (cpu_t cpu)
 {
     if (!cpus.tas (cpu)) {
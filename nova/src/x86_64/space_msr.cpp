@@ -42,21 +42,6 @@ Space_msr::Space_msr() : Space { Kobject::Subtype::MSR }, bmp { new Bitmap_msr }
         access_ctrl (msr, Paging::Permissions (Paging::R));
 }
 
-/*
- * Lookup MSR permissions for the specified selector
- *
- * @param s     Selector whose permissions are being looked up
- * @return      Permissions for the specified selector
- */
-Paging::Permissions Space_msr::lookup (unsigned long s) const
-{
-    if (EXPECT_TRUE (bmp->sel_valid (s)))
-        return Paging::Permissions (!bmp->tst_w (s) * Paging::W |
-                                    !bmp->tst_r (s) * Paging::R);
-
-    return Paging::NONE;
-}
-
 /*
  * Update MSR permissions for the specified selector
  *
@@ -88,8 +73,7 @@ Status Space_msr::delegate (Space_msr const *msr, unsigned long ssb, unsigned lo
     if (EXPECT_FALSE (ssb != dsb || !Bitmap_msr::sel_valid (e - 1)))
         return Status::BAD_PAR;
 
-    for (auto s { ssb }; s < e; s++)
-        update (s, Paging::Permissions (msr->lookup (s) & pmm));
+    bmp->update (ssb, BITN (ord), msr->bmp, !(pmm & Paging::R), !(pmm & Paging::W));
 
     return Status::SUCCESS;
 }
@@ -35,32 +35,6 @@ Space_pio::Space_pio() : Space { Kobject::Subtype::PIO }, hst { nullptr }, bmp {
     access_ctrl (0, BIT (16), Paging::R);
 }
 
-/*
- * Lookup PIO permissions for the specified selector
- *
- * @param s     Selector whose permissions are being looked up
- * @return      Permissions for the specified selector
- */
-Paging::Permissions Space_pio::lookup (unsigned long s) const
-{
-    if (EXPECT_TRUE (bmp->sel_valid (s)))
-        return Paging::Permissions (!bmp->tst (s) * Paging::R);
-
-    return Paging::NONE;
-}
-
-/*
- * Update PIO permissions for the specified selector
- *
- * @param s     Selector whose permissions are being updated
- * @param p     Permissions for the specified selector
- */
-void Space_pio::update (unsigned long s, Paging::Permissions p)
-{
-    if (EXPECT_TRUE (bmp->sel_valid (s)))
-        p & Paging::R ? bmp->clr (s) : bmp->set (s);
-}
-
 /*
  * Delegate PIO capability range
  *
@@ -78,8 +52,7 @@ Status Space_pio::delegate (Space_pio const *pio, unsigned long ssb, unsigned lo
     if (EXPECT_FALSE (ssb != dsb || !Bitmap_pio::sel_valid (e - 1)))
         return Status::BAD_PAR;
 
-    for (auto s { ssb }; s < e; s++)
-        update (s, Paging::Permissions (pio->lookup (s) & pmm));
+    bmp->update (ssb, BITN (ord), pio->bmp, !(pmm & Paging::R));
 
     return Status::SUCCESS;
 }
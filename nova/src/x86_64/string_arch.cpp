@@ -0,0 +1,43 @@
+/*
+ * String Functions: Architecture-Specific Part (x86)
+ *
+ * Copyright (C) 2019-2024 Udo Steinberg, BedRock Systems, Inc.
+ *
+ * This file is part of the NOVA microhypervisor.
+ *
+ * NOVA is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * NOVA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ */
+
+#include "patch.hpp"
+#include "string.hpp"
+
+/*
+ * With ERMS, a single REP MOVSB/STOSB is the fastest copy/fill for any size.
+ * Without ERMS, REP MOVSQ/STOSQ handles the words and REP MOVSB/STOSB the remaining bytes.
+ */
+extern "C" void *memcpy (void *d, void const *s, size_t n)
+{
+    auto dst { d };
+
+    #define ASM_MEMCPY mov %%rcx, %%rdx; shr $3, %%rcx; rep movsq; mov %%edx, %%ecx; and $7, %%ecx; rep movsb
+    asm volatile (EXPAND (PATCH (rep movsb, ASM_MEMCPY, PATCH_ERMS)) : "+D" (dst), "+S" (s), "+c" (n) : : "rdx", "memory");
+
+    return d;
+}
+
+extern "C" void *memset (void *d, int c, size_t n)
+{
+    auto dst { d };
+
+    #define ASM_MEMSET mov %%rcx, %%rdx; shr $3, %%rcx; rep stosq; mov %%edx, %%ecx; and $7, %%ecx; rep stosb
+    asm volatile (EXPAND (PATCH (rep stosb, ASM_MEMSET, PATCH_ERMS)) : "+D" (dst), "+c" (n) : "a" (static_cast<uint8_t>(c) * 0x0101010101010101UL) : "rdx", "memory");
+
+    return d;
+}
@@ -19,19 +19,30 @@
  * GNU General Public License version 2 for more details.
  */
 
-#include "counter.hpp"
 #include "ec.hpp"
 #include "interrupt.hpp"
+#include "lock_guard.hpp"
 #include "space_gst.hpp"
 #include "space_hst.hpp"
-#include "stc.hpp"
+#include "statistics.hpp"
 #include "stdio.hpp"
 #include "tlb.hpp"
 #include "wait.hpp"
 
-void Tlb::shootdown (Space *s)
+Tlb::Mailbox Tlb::mbox;
+uint16_t     Tlb::tkt[NUM_CPU];
+
+/*
+ * Shoot down the TLB entries of a space in the range [b, e) on all CPUs where the space is current
+ *
+ * IPIs are sent to all targets before waiting for the first acknowledgment,
+ * so the remote handlers run in parallel and the initiator waits only once.
+ *
+ * @return      True if all targets acknowledged the shootdown, false if any of them timed out
+ */
+bool Tlb::shootdown (Space *s, uintptr_t b, uintptr_t e)
 {
-    Cpu::preemption_enable();
+    Cpuset cpus;
 
     for (cpu_t cpu { 0 }; cpu < Cpu::count; cpu++) {
 
@@ -45,12 +56,97 @@ void Tlb::shootdown (Space *s)
             continue;
         }
 
-        auto const c { Counter::req[Interrupt::Request::RKE].get (cpu) };
+        auto &m { *Kmem::loc_to_glob (cpu, &mbox) };
+
+        {   Lock_guard <Spinlock> guard { m.lock };
+
+            // Merge range with pending shootdowns; mixed spaces degrade to a full flush
+            if (!m.ops++) {
+                m.space = s;
+                m.base  = b;
+                m.limit = e;
+            } else if (m.space != s)
+                m.space = nullptr;
+            else {
+                m.base  = min (m.base,  b);
+                m.limit = max (m.limit, e);
+            }
+
+            tkt[cpu] = ++m.req;
+        }
+
+        cpus.tas (cpu);
 
         Interrupt::send_cpu (Interrupt::Request::RKE, cpu);
 
-        Wait::until (1, [&] { return Counter::req[Interrupt::Request::RKE].get (cpu) != c; });
+        Statistics::cpu().tlb_send.inc();
+    }
+
+    bool ok { true };
+
+    Cpu::preemption_enable();
+
+    for (cpu_t cpu { 0 }; cpu < Cpu::count; cpu++) {
+
+        if (!cpus.tst (cpu))
+            continue;
+
+        auto const &m { *Kmem::loc_to_glob (cpu, &mbox) };
+
+        // Later requests of other initiators must not delay this one
+        ok &= Wait::until (1, [&] { return static_cast<int16_t>(m.ack - tkt[cpu]) >= 0; });
     }
 
     Cpu::preemption_disable();
+
+    return ok;
+}
+
+/*
+ * Consume the shootdown mailbox of the current CPU (RKE handler)
+ *
+ * Small ranges of the current host space are invalidated page-selectively,
+ * which avoids rescheduling and the reload of the entire address space.
+ * The invalidation bit may only be cleared if every shootdown in flight for
+ * the space has been merged into the mailbox; otherwise a concurrent shootdown
+ * may have set the bit after its page-table update and before its merge.
+ */
+void Tlb::handler()
+{
+    Space *s;
+    uintptr_t b, e;
+    unsigned n;
+    uint16_t r;
+
+    {   Lock_guard <Spinlock> guard { mbox.lock };
+
+        s = mbox.space;
+        b = mbox.base;
+        e = mbox.limit;
+        n = mbox.ops;
+        r = mbox.req;
+
+        mbox.space = nullptr;
+        mbox.ops   = 0;
+    }
+
+    Statistics::cpu().tlb_recv.add (n);
+
+    auto const hst { Space_hst::current };
+
+    if (hst->htlb.tst (Cpu::id)) {
+
+        hst->htlb.clr (Cpu::id);
+
+        if (n && s == hst && e - b <= max_pages * PAGE_SIZE (0) && hst->inflight.load (__ATOMIC_SEQ_CST) == n)
+            for (b &= ~OFFS_MASK (0); b < e; b += PAGE_SIZE (0))
+                Hptp::invalidate (b);
+
+        else {
+            hst->htlb.tas (Cpu::id);
+            Cpu::hazard |= Hazard::SCHED;
+        }
+    }
+
+    mbox.ack = r;
 }
@@ -208,6 +208,9 @@ void Utcb_arch::load_vmx (Mtd_arch const m, Cpu_regs const &c)
 
     if (m & Mtd_arch::Item::TSC)
         tsc_aux = c.gst_tsc.tsc_aux;
+
+    if (m & Mtd_arch::Item::EXIT)
+        knl_exit = c.exc.knl_exit;
 }
 
 bool Utcb_arch::save_vmx (Mtd_arch const m, Cpu_regs &c, Space_obj const *obj) const
@@ -396,6 +399,9 @@ bool Utcb_arch::save_vmx (Mtd_arch const m, Cpu_regs &c, Space_obj const *obj) c
     if (m & Mtd_arch::Item::TSC)
         c.gst_tsc.tsc_aux = Cpu::State_tsc::constrain_tsc_aux (tsc_aux);
 
+    if (m & Mtd_arch::Item::EXIT)
+        c.exc.knl_exit = knl_exit & (Exit::RDTSC | Exit::RDTSCP | Exit::PAUSE | Exit::XSETBV | Exit::MSR);
+
     if (m & Mtd_arch::Item::TLB) {
 
         auto vpid = Vmcs::vpid();
@@ -34,6 +34,7 @@
 #include "tss.hpp"
 #include "util.hpp"
 #include "vmx.hpp"
+#include "vpid.hpp"
 
 Vmcs *      Vmcs::root        { nullptr };
 Vmcs *      Vmcs::current     { nullptr };
@@ -49,7 +50,7 @@ uint64_t    Vmcs::cpu_ter_clr { 0 }, Vmcs::cpu_ter_set { 0 };
 uintptr_t   Vmcs::fix_cr0_clr { 0 }, Vmcs::fix_cr0_set { 0 };
 uintptr_t   Vmcs::fix_cr4_clr { 0 }, Vmcs::fix_cr4_set { 0 };
 
-void Vmcs::init (uintptr_t gsp, uintptr_t hsp, uintptr_t cr3, uint64_t apic, uint16_t vpid)
+void Vmcs::init (uintptr_t gsp, uintptr_t hsp, uintptr_t cr3, uint64_t apic)
 {
     // Set VMCS launch state to "clear" and initialize implementation-specific VMCS state.
     clear();
@@ -83,7 +84,7 @@ void Vmcs::init (uintptr_t gsp, uintptr_t hsp, uintptr_t cr3, uint64_t apic, uin
     write (Encoding::APIC_PAGE_ADDR, apic);
     write (Encoding::APIC_ACCS_ADDR, Kmem::ptr_to_phys (this));
     write (Encoding::VMCS_LINK_PTR, ~0ULL);
-    write (Encoding::VPID, vpid);
+    write (Encoding::VPID, 0);     // Assigned before the first VM entry
 
     write (Encoding::HOST_SEL_CS, SEL_KERN_CODE);
     write (Encoding::HOST_SEL_SS, SEL_KERN_DATA);
@@ -213,6 +214,10 @@ void Vmcs::init()
 
     vmxon();
 
+    // Start the first VPID generation, which also discards stale tags after a resume
+    if (has_vpid())
+        Vpid::rollover();
+
     trace (TRACE_VIRT, "VMCS: Revision:%#x (%#x:%#x:%#lx)", root->rev, cpu_pri_clr, cpu_sec_clr, cpu_ter_clr);
 }
 
@@ -20,4 +20,5 @@
 
 #include "vpid.hpp"
 
-Atomic<uint16_t> Vpid::allocator { 0 };
+uint16_t Vpid::next;
+uint32_t Vpid::gen;